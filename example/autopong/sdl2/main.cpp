@@ -15,12 +15,15 @@
 #include <SDL.h>
 #include <SDL_ttf.h>
 
+#include <lager/batch.hpp>
 #include <lager/debug/debugger.hpp>
 #include <lager/debug/http_server.hpp>
 #include <lager/event_loop/sdl.hpp>
+#include <lager/fixed_timestep.hpp>
 #include <lager/resources_path.hpp>
 #include <lager/store.hpp>
 
+#include <chrono>
 #include <cmath>
 #include <iostream>
 #include <string>
@@ -154,11 +157,11 @@ int main(int argc, const char** argv)
                                             autopong::update,
                                             lager::with_sdl_event_loop{loop},
 #ifdef DEBUGGER
-                                            lager::with_debugger(debugger)
-#else
-                                            lager::identity
+                                            lager::with_debugger(debugger),
 #endif
-        );
+                                            lager::with_batches());
+    using ms      = std::chrono::duration<float, std::milli>;
+    auto timestep = lager::fixed_timestep<>{ms{1000.f / 120.f}};
     watch(store, [&](auto&& val) { draw(view, LAGER_FWD(val)); });
     loop.run(
         [&](const SDL_Event& ev) {
@@ -167,7 +170,9 @@ int main(int argc, const char** argv)
             return ev.type != SDL_QUIT;
         },
         [&](float delta) {
-            store.dispatch(autopong::tick_action{delta});
+            if (auto n = timestep.advance(ms{delta}))
+                store.dispatch(lager::batch_action<autopong::action>{
+                    n, autopong::tick_action{timestep.step().count()}});
             return true;
         });
 }
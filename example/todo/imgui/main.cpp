@@ -13,6 +13,7 @@
 #include "../todo.hpp"
 
 #include <lager/event_loop/sdl.hpp>
+#include <lager/extra/imgui.hpp>
 #include <lager/store.hpp>
 
 #include <imgui.h>
@@ -33,9 +34,13 @@ struct ui_state
     static constexpr std::size_t input_string_size = 1 << 10;
 
     std::array<char, input_string_size> new_todo_input{'\0'};
+
+    // Contexts for dispatching the actions of every item, kept across frames.
+    lager::frame_cache<std::size_t, lager::context<todo::item_action>>
+        item_contexts;
 };
 
-void draw(lager::context<todo::item_action> ctx, const todo::item& i)
+void draw(const lager::context<todo::item_action>& ctx, const todo::item& i)
 {
     auto checked = i.done;
     if (ImGui::Checkbox("", &checked)) {
@@ -91,13 +96,19 @@ void draw(lager::context<todo::action> ctx, const todo::model& m, ui_state& s)
     ImGui::BeginChild("");
     {
         auto idx = std::size_t{};
-        for (auto item : m.todos) {
+        for (const auto& item : m.todos) {
             ImGui::PushID(idx);
-            auto with_idx = [idx](auto&& a) { return std::make_pair(idx, a); };
-            draw({ctx, with_idx}, item);
+            auto& item_ctx = s.item_contexts.get(idx, [&] {
+                auto with_idx = [idx](auto&& a) {
+                    return std::make_pair(idx, a);
+                };
+                return lager::context<todo::item_action>{ctx, with_idx};
+            });
+            draw(item_ctx, item);
             ImGui::PopID();
             ++idx;
         }
+        s.item_contexts.collect();
     }
     ImGui::EndChild();
 
@@ -0,0 +1,178 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/access.hpp>
+#include <lager/detail/aggregate_nodes.hpp>
+#include <lager/diff.hpp>
+#include <lager/reader.hpp>
+
+#include <immer/map.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace lager {
+
+namespace detail {
+
+template <typename T, typename Add, typename Remove>
+struct aggregator
+{
+    using value_type = T;
+
+    T init;
+    Add add;
+    Remove remove;
+};
+
+template <typename Container>
+struct bucket_traits
+{
+    template <typename T>
+    static Container insert(Container c, const T& x)
+    {
+        return std::move(c).insert(x);
+    }
+
+    template <typename T>
+    static Container erase(Container c, const T& x)
+    {
+        return std::move(c).erase(x);
+    }
+};
+
+template <typename K,
+          typename T,
+          typename Hash,
+          typename Equal,
+          typename MemoryPolicy,
+          std::uint32_t B>
+struct bucket_traits<immer::map<K, T, Hash, Equal, MemoryPolicy, B>>
+{
+    using container_t = immer::map<K, T, Hash, Equal, MemoryPolicy, B>;
+
+    template <typename KV>
+    static container_t insert(container_t c, const KV& x)
+    {
+        return std::move(c).set(x.first, x.second);
+    }
+
+    template <typename KV>
+    static container_t erase(container_t c, const KV& x)
+    {
+        return std::move(c).erase(x.first);
+    }
+};
+
+} // namespace detail
+
+//! @defgroup aggregate
+//! @{
+
+/*!
+ * Returns a reader with an aggregate over the elements of the container in
+ * the reader `r`.  The aggregate starts as `init` and `add(value, x)` and
+ * `remove(value, x)` return it updated with an element added to or removed
+ * from the container.
+ *
+ * The aggregate is maintained incrementally: when the container changes, only
+ * the elements that differ from the previous version are passed to `add` and
+ * `remove`, as computed by `lager::changes_traits`.  For `immer::map` and
+ * `immer::set` (see `lager/diff.hpp`), the cost of this is proportional to
+ * the number of changed elements and not to the size of the container.
+ */
+template <typename ReaderT, typename T, typename Add, typename Remove>
+auto aggregate(ReaderT&& r, T init, Add add, Remove remove)
+{
+    auto agg = detail::aggregator<T, Add, Remove>{
+        std::move(init), std::move(add), std::move(remove)};
+    auto node = detail::make_aggregate_reader_node(
+        std::move(agg),
+        std::make_tuple(detail::access::node(std::forward<ReaderT>(r).make())));
+    return reader_base<typename decltype(node)::element_type>{std::move(node)};
+}
+
+/*!
+ * Returns a reader with the number of elements `x` of the container in the
+ * reader `r` for which `pred(x)` is true, maintained incrementally.
+ * @see `aggregate()`
+ */
+template <typename ReaderT, typename Pred>
+auto count_if(ReaderT&& r, Pred pred)
+{
+    return aggregate(
+        std::forward<ReaderT>(r),
+        std::size_t{},
+        [pred](std::size_t n, const auto& x) { return n + (pred(x) ? 1 : 0); },
+        [pred](std::size_t n, const auto& x) { return n - (pred(x) ? 1 : 0); });
+}
+
+/*!
+ * Returns a reader with the sum of `fn(x)` for every element `x` of the
+ * container in the reader `r`, maintained incrementally.  The result type
+ * must support `+` and `-`.  @see `aggregate()`
+ */
+template <typename ReaderT, typename Fn>
+auto sum_by(ReaderT&& r, Fn fn)
+{
+    using container_t = typename std::decay_t<ReaderT>::value_type;
+    using element_t   = typename container_t::value_type;
+    using result_t    = std::decay_t<std::invoke_result_t<Fn&, element_t>>;
+    return aggregate(
+        std::forward<ReaderT>(r),
+        result_t{},
+        [fn](result_t acc, const auto& x) { return std::move(acc) + fn(x); },
+        [fn](result_t acc, const auto& x) { return std::move(acc) - fn(x); });
+}
+
+/*!
+ * Returns a reader with the elements of the container in the reader `r`
+ * grouped by `key(x)`.  The result is an `immer::map` from the keys to
+ * containers of the same type as the source, holding the elements with that
+ * key.  Empty groups are removed.  It is maintained incrementally, so only
+ * the groups of the changed elements are updated.  @see `aggregate()`
+ */
+template <typename ReaderT, typename KeyFn>
+auto group_by(ReaderT&& r, KeyFn key)
+{
+    using container_t = typename std::decay_t<ReaderT>::value_type;
+    using element_t   = typename container_t::value_type;
+    using key_t       = std::decay_t<std::invoke_result_t<KeyFn&, element_t>>;
+    using groups_t    = immer::map<key_t, container_t>;
+    using bucket_t    = detail::bucket_traits<container_t>;
+    return aggregate(
+        std::forward<ReaderT>(r),
+        groups_t{},
+        [key](groups_t gs, const auto& x) {
+            auto k      = key(x);
+            auto bucket = gs.find(k);
+            return std::move(gs).set(
+                k, bucket_t::insert(bucket ? *bucket : container_t{}, x));
+        },
+        [key](groups_t gs, const auto& x) {
+            auto k      = key(x);
+            auto bucket = gs.find(k);
+            if (!bucket)
+                return gs;
+            auto rest = bucket_t::erase(*bucket, x);
+            return rest.empty() ? std::move(gs).erase(k)
+                                : std::move(gs).set(k, std::move(rest));
+        });
+}
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,119 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/context.hpp>
+#include <lager/util.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace lager {
+
+/*!
+ * Action holding a sequence of actions that are reduced together by a store
+ * using the `with_batches()` enhancer.  @see `with_batches()`
+ */
+template <typename Action>
+struct batch_action
+{
+    std::vector<Action> actions;
+
+    batch_action() = default;
+
+    batch_action(std::vector<Action> acts)
+        : actions{std::move(acts)}
+    {}
+
+    /*!
+     * Batch of `count` copies of `action`, like the simulation steps computed
+     * by a `fixed_timestep`.
+     */
+    batch_action(std::size_t count, const Action& action)
+        : actions(count, action)
+    {}
+
+    template <typename Action2,
+              std::enable_if_t<std::is_convertible_v<Action2, Action>, int> = 0>
+    batch_action(batch_action<Action2> other)
+        : actions(std::make_move_iterator(other.actions.begin()),
+                  std::make_move_iterator(other.actions.end()))
+    {}
+};
+
+/*!
+ * Store enhancer that lets the store also take `batch_action<Action>`.  The
+ * actions of a batch are passed through the reducer one after another, but
+ * the resulting model is propagated and watchers are notified only once.
+ * The effects of the actions are evaluated afterwards, in order.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto store = lager::make_store<action>(
+ *        model{}, update, event_loop, lager::with_batches());
+ *    store.dispatch(lager::batch_action<action>{3, tick_action{}});
+ *
+ * @endrst
+ */
+inline auto with_batches()
+{
+    return [](auto next) {
+        return [next](auto action,
+                      auto&& model,
+                      auto&& reducer,
+                      auto&& loop,
+                      auto&& deps) {
+            using action_t   = typename decltype(action)::type;
+            using model_t    = std::decay_t<decltype(model)>;
+            using deps_t     = std::decay_t<decltype(deps)>;
+            using batch_t    = batch_action<action_t>;
+            using new_action = std::variant<action_t, batch_t>;
+            using effect_t   = effect<new_action, deps_t>;
+            using result_t   = std::pair<model_t, effect_t>;
+            return next(
+                type_<new_action>{},
+                LAGER_FWD(model),
+                [reducer = LAGER_FWD(reducer)](model_t m,
+                                               new_action act) -> result_t {
+                    auto eff    = effect_t{noop};
+                    auto reduce = [&](action_t a) {
+                        m = invoke_reducer<deps_t>(
+                            reducer,
+                            std::move(m),
+                            std::move(a),
+                            [&](auto&& e) {
+                                eff = sequence(eff, effect_t{LAGER_FWD(e)});
+                            },
+                            [] {});
+                    };
+                    std::visit(visitor{[&](action_t& a) { reduce(a); },
+                                       [&](batch_t& b) {
+                                           for (auto& a : b.actions)
+                                               reduce(std::move(a));
+                                       }},
+                               act);
+                    return {std::move(m), std::move(eff)};
+                },
+                LAGER_FWD(loop),
+                LAGER_FWD(deps));
+        };
+    };
+}
+
+} // namespace lager
@@ -0,0 +1,134 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/budget.hpp>
+#include <lager/util.hpp>
+
+#include <chrono>
+#include <functional>
+#include <utility>
+
+namespace lager {
+
+//! @defgroup cursors
+//! @{
+
+/*!
+ * Limits the time spent notifying watchers while this object is alive in the
+ * current thread.  Watchers with a priority lower than
+ * `watch_priority::normal` that would be notified after the @a budget is
+ * exhausted are instead posted to the event loop @a loop, where they are
+ * notified with the latest value on its next iteration.  Higher priority
+ * watchers always run.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    {
+ *        using namespace std::chrono_literals;
+ *        auto budget = lager::notify_budget{loop, 4ms};
+ *        lager::commit(state);
+ *    }
+ *
+ * @endrst
+ */
+template <typename EventLoop>
+class notify_budget : public detail::notify_budget_base
+{
+    EventLoop loop_;
+
+public:
+    template <typename Rep, typename Period>
+    notify_budget(EventLoop loop, std::chrono::duration<Rep, Period> budget)
+        : notify_budget_base{
+              std::chrono::duration_cast<clock_t::duration>(budget)}
+        , loop_{std::move(loop)}
+    {}
+
+    void defer(std::function<void()> fn) override
+    {
+        loop_.post(std::move(fn));
+    }
+};
+
+template <typename EventLoop, typename Rep, typename Period>
+notify_budget(EventLoop, std::chrono::duration<Rep, Period>)
+    ->notify_budget<EventLoop>;
+
+/*!
+ * Event loop adaptor that runs every posted function within a
+ * `notify_budget`.  Deferred watchers are posted back to this event loop, so
+ * they also run within a budget.
+ */
+template <typename EventLoop>
+struct with_notify_budget_event_loop
+{
+    using duration_t = std::chrono::steady_clock::duration;
+
+    EventLoop loop;
+    duration_t budget;
+
+    template <typename Fn>
+    void async(Fn&& fn)
+    {
+        loop.async(std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    void post(Fn&& fn)
+    {
+        // Stores keep their event loop by value and may be moved, so the
+        // deferred watchers are posted through a copy of this loop.
+        loop.post([self = *this, fn = std::forward<Fn>(fn)]() mutable {
+            auto scope =
+                notify_budget<with_notify_budget_event_loop>{self, self.budget};
+            fn();
+        });
+    }
+
+    void finish() { loop.finish(); }
+    void pause() { loop.pause(); }
+    void resume() { loop.resume(); }
+};
+
+/*!
+ * Store enhancer that notifies watchers within a time @a budget per event loop
+ * iteration, deferring low priority watchers.  @see `notify_budget`.
+ */
+template <typename Rep, typename Period>
+auto with_notify_budget(std::chrono::duration<Rep, Period> budget)
+{
+    auto d =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(budget);
+    return [d](auto next) {
+        return [d, next](auto action,
+                         auto&& model,
+                         auto&& reducer,
+                         auto&& loop,
+                         auto&& deps) {
+            using loop_t = with_notify_budget_event_loop<
+                std::decay_t<decltype(loop)>>;
+            return next(action,
+                        LAGER_FWD(model),
+                        LAGER_FWD(reducer),
+                        loop_t{LAGER_FWD(loop), d},
+                        LAGER_FWD(deps));
+        };
+    };
+}
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,456 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/debug/cereal/variant_with_name.hpp>
+
+#include <cereal/cereal.hpp>
+#include <immer/box.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace lager {
+
+namespace detail {
+namespace json_adl {
+
+template <typename A, typename T, typename = void>
+struct has_member_serialize : std::false_type
+{};
+
+template <typename A, typename T>
+struct has_member_serialize<
+    A,
+    T,
+    std::void_t<decltype(std::declval<T&>().serialize(std::declval<A&>()))>>
+    : std::true_type
+{};
+
+template <typename A, typename T, typename = void>
+struct has_member_save : std::false_type
+{};
+
+template <typename A, typename T>
+struct has_member_save<
+    A,
+    T,
+    std::void_t<decltype(std::declval<const T&>().save(std::declval<A&>()))>>
+    : std::true_type
+{};
+
+template <typename A, typename T, typename = void>
+struct has_serialize : std::false_type
+{};
+
+template <typename A, typename T>
+struct has_serialize<
+    A,
+    T,
+    std::void_t<decltype(serialize(std::declval<A&>(), std::declval<T&>()))>>
+    : std::true_type
+{};
+
+template <typename A, typename T, typename = void>
+struct has_save : std::false_type
+{};
+
+template <typename A, typename T>
+struct has_save<
+    A,
+    T,
+    std::void_t<decltype(save(std::declval<A&>(), std::declval<const T&>()))>>
+    : std::true_type
+{};
+
+template <typename A, typename T>
+void invoke_serialize(A& ar, const T& x)
+{
+    auto& y = const_cast<T&>(x);
+    if constexpr (has_member_serialize<A, T>::value)
+        y.serialize(ar);
+    else if constexpr (has_member_save<A, T>::value)
+        x.save(ar);
+    else if constexpr (has_serialize<A, T>::value)
+        serialize(ar, y);
+    else
+        save(ar, x);
+}
+
+} // namespace json_adl
+
+template <typename T>
+struct is_json_optional : std::false_type
+{};
+template <typename T>
+struct is_json_optional<std::optional<T>> : std::true_type
+{};
+
+template <typename T>
+struct is_json_variant : std::false_type
+{};
+template <typename... Ts>
+struct is_json_variant<std::variant<Ts...>> : std::true_type
+{};
+
+template <typename T>
+struct is_json_box : std::false_type
+{};
+template <typename T, typename MP>
+struct is_json_box<immer::box<T, MP>> : std::true_type
+{};
+
+template <typename T>
+struct is_json_pair : std::false_type
+{};
+template <typename T, typename U>
+struct is_json_pair<std::pair<T, U>> : std::true_type
+{};
+
+template <typename T>
+struct is_json_tuple : std::false_type
+{};
+template <typename... Ts>
+struct is_json_tuple<std::tuple<Ts...>> : std::true_type
+{};
+
+template <typename T>
+struct is_json_nvp : std::false_type
+{};
+template <typename T>
+struct is_json_nvp<cereal::NameValuePair<T>> : std::true_type
+{};
+
+template <typename T>
+struct is_json_size_tag : std::false_type
+{};
+template <typename T>
+struct is_json_size_tag<cereal::SizeTag<T>> : std::true_type
+{};
+
+template <typename T, typename = void>
+struct is_json_map : std::false_type
+{};
+template <typename T>
+struct is_json_map<T, std::void_t<typename T::mapped_type>> : std::true_type
+{};
+
+template <typename T, typename = void>
+struct is_json_range : std::false_type
+{};
+template <typename T>
+struct is_json_range<T,
+                     std::void_t<decltype(std::begin(std::declval<const T&>())),
+                                 decltype(std::end(std::declval<const T&>()))>>
+    : std::true_type
+{};
+
+} // namespace detail
+
+/*!
+ * Output archive that writes JSON directly into a string buffer.  It
+ * produces the same documents as `cereal::JSONOutputArchive`, without the
+ * indentation, so they can be read back with `cereal::JSONInputArchive`.
+ *
+ * Types with `LAGER_CEREAL_STRUCT` or other `serialize()` and `save()`
+ * functions are supported, as well as arithmetic types, strings, enums,
+ * `std::optional`, `std::variant` (as by
+ * `lager/debug/cereal/variant_with_name.hpp`), pairs, tuples, `immer::box`
+ * and any other container.  The output is appended to the string passed to
+ * the constructor, so the same buffer can be reused for many documents to
+ * avoid reallocations.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    thread_local auto buffer = std::string{};
+ *    buffer.clear();
+ *    {
+ *        auto ar = lager::json_writer{buffer};
+ *        ar(cereal::make_nvp("model", model));
+ *    }
+ *    send(buffer);
+ *
+ * @endrst
+ */
+class json_writer
+{
+public:
+    json_writer(std::string& out)
+        : out_{out}
+    {
+        stack_.reserve(16);
+        stack_.push_back({});
+    }
+
+    json_writer(const json_writer&) = delete;
+    json_writer& operator=(const json_writer&) = delete;
+
+    ~json_writer() { finish(); }
+
+    template <typename... Ts>
+    json_writer& operator()(Ts&&... xs)
+    {
+        (write(xs), ...);
+        return *this;
+    }
+
+    /*!
+     * Closes the document.  This is done automatically on destruction.
+     */
+    void finish()
+    {
+        while (!stack_.empty())
+            end_node();
+    }
+
+    /*!
+     * Appends `str` to `out` as a quoted JSON string.
+     */
+    static void write_string(std::string& out, std::string_view str)
+    {
+        static constexpr char hex[] = "0123456789abcdef";
+        out += '"';
+        auto first = str.data();
+        auto last  = first + str.size();
+        for (auto it = first; it != last; ++it) {
+            auto c = static_cast<unsigned char>(*it);
+            if (c >= 0x20 && c != '"' && c != '\\')
+                continue;
+            out.append(first, it);
+            first = it + 1;
+            out += '\\';
+            switch (c) {
+            case '"':
+            case '\\':
+                out += static_cast<char>(c);
+                break;
+            case '\b':
+                out += 'b';
+                break;
+            case '\f':
+                out += 'f';
+                break;
+            case '\n':
+                out += 'n';
+                break;
+            case '\r':
+                out += 'r';
+                break;
+            case '\t':
+                out += 't';
+                break;
+            default:
+                out += "u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xf];
+            }
+        }
+        out.append(first, last);
+        out += '"';
+    }
+
+private:
+    struct frame
+    {
+        bool array          = false;
+        bool open           = false;
+        std::uint32_t count = 0;
+        std::uint32_t names = 0;
+    };
+
+    template <typename T>
+    static const std::string& quoted_type_name()
+    {
+        static const auto name = [] {
+            auto r = std::string{};
+            write_string(r, cereal::detail::get_type_name<T>());
+            return r;
+        }();
+        return name;
+    }
+
+    void begin_value()
+    {
+        auto& f = stack_.back();
+        if (!f.open) {
+            out_ += f.array ? '[' : '{';
+            f.open = true;
+        }
+        if (f.count++)
+            out_ += ',';
+        if (!f.array) {
+            if (next_name_) {
+                write_string(out_, next_name_);
+            } else {
+                char buf[32] = "\"value";
+                auto r = std::to_chars(buf + 6, buf + sizeof(buf), f.names++);
+                *r.ptr++ = '"';
+                out_.append(buf, r.ptr);
+            }
+            out_ += ':';
+        }
+        next_name_ = nullptr;
+    }
+
+    void begin_node()
+    {
+        begin_value();
+        stack_.push_back({});
+    }
+
+    void begin_array()
+    {
+        begin_node();
+        stack_.back().array = true;
+    }
+
+    void end_node()
+    {
+        auto& f = stack_.back();
+        if (!f.open)
+            out_ += f.array ? '[' : '{';
+        out_ += f.array ? ']' : '}';
+        stack_.pop_back();
+    }
+
+    template <typename T>
+    void write_number(T x)
+    {
+        char buf[64];
+        auto r = std::to_chars(buf, buf + sizeof(buf), x);
+        out_.append(buf, r.ptr);
+    }
+
+    template <typename T>
+    void write_float(T x)
+    {
+        if (!std::isfinite(x)) {
+            out_ += "null";
+            return;
+        }
+        char buf[64];
+        auto r   = std::to_chars(buf, buf + sizeof(buf), x);
+        auto end = r.ptr;
+        // Keep the value a floating point number when read back
+        if (std::find_if(buf, end, [](char c) {
+                return c == '.' || c == 'e';
+            }) == end) {
+            *end++ = '.';
+            *end++ = '0';
+        }
+        out_.append(buf, end);
+    }
+
+    template <typename T>
+    void write(const T& x)
+    {
+        using namespace detail;
+        if constexpr (is_json_nvp<T>::value) {
+            next_name_ = x.name;
+            write(x.value);
+        } else if constexpr (is_json_size_tag<T>::value) {
+            stack_.back().array = true;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            begin_value();
+            out_ += x ? "true" : "false";
+        } else if constexpr (std::is_floating_point_v<T>) {
+            begin_value();
+            write_float(x);
+        } else if constexpr (std::is_arithmetic_v<T>) {
+            begin_value();
+            write_number(x);
+        } else if constexpr (std::is_enum_v<T>) {
+            begin_value();
+            write_number(static_cast<std::underlying_type_t<T>>(x));
+        } else if constexpr (std::is_convertible_v<const T&,
+                                                   std::string_view>) {
+            begin_value();
+            write_string(out_, x);
+        } else if constexpr (is_json_optional<T>::value) {
+            begin_node();
+            (*this)(cereal::make_nvp("nullopt", !x.has_value()));
+            if (x)
+                (*this)(cereal::make_nvp("data", *x));
+            end_node();
+        } else if constexpr (is_json_variant<T>::value) {
+            begin_node();
+            std::visit(
+                [&](auto& v) {
+                    next_name_ = "type";
+                    begin_value();
+                    out_ += quoted_type_name<std::decay_t<decltype(v)>>();
+                    (*this)(cereal::make_nvp("data", v));
+                },
+                x);
+            end_node();
+        } else if constexpr (is_json_box<T>::value) {
+            begin_node();
+            (*this)(cereal::make_nvp("value", x.get()));
+            end_node();
+        } else if constexpr (is_json_pair<T>::value) {
+            begin_node();
+            (*this)(cereal::make_nvp("first", x.first),
+                    cereal::make_nvp("second", x.second));
+            end_node();
+        } else if constexpr (is_json_tuple<T>::value) {
+            begin_array();
+            std::apply([&](auto&... vs) { (*this)(vs...); }, x);
+            end_node();
+        } else if constexpr (json_adl::has_member_serialize<json_writer,
+                                                            T>::value ||
+                             json_adl::has_member_save<json_writer,
+                                                       T>::value ||
+                             json_adl::has_serialize<json_writer, T>::value ||
+                             json_adl::has_save<json_writer, T>::value) {
+            begin_node();
+            json_adl::invoke_serialize(*this, x);
+            end_node();
+        } else if constexpr (is_json_map<T>::value) {
+            begin_array();
+            for (auto&& [k, v] : x) {
+                begin_node();
+                (*this)(cereal::make_nvp("key", k),
+                        cereal::make_nvp("value", v));
+                end_node();
+            }
+            end_node();
+        } else if constexpr (is_json_range<T>::value) {
+            begin_array();
+            for (auto&& v : x)
+                write(v);
+            end_node();
+        } else {
+            static_assert(!std::is_same_v<T, T>,
+                          "json_writer does not know how to write this type");
+        }
+    }
+
+    std::string& out_;
+    std::vector<frame> stack_;
+    const char* next_name_ = nullptr;
+};
+
+} // namespace lager
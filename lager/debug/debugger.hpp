@@ -17,27 +17,91 @@
 #include <lager/util.hpp>
 
 #include <immer/algorithm.hpp>
+#include <immer/memory_policy.hpp>
 #include <immer/vector.hpp>
 
 #include <lager/debug/cereal/immer_vector.hpp>
 #include <lager/debug/cereal/struct.hpp>
 #include <lager/debug/cereal/variant_with_name.hpp>
+#include <lager/debug/search_index.hpp>
 
 #include <zug/transducer/map.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <variant>
+#include <vector>
 
 namespace lager {
 
-template <typename Action, typename Model, typename Deps>
+/*!
+ * Time, in nanoseconds, that the `debugger` spent processing a step, when
+ * timing is enabled.  `propagation` goes from the end of the reducer to the
+ * start of its effects, which includes propagating the new model to the
+ * derived cursors and notifying the watchers.  It and `effects` are filled in
+ * when the effects run, and are -1 until then.
+ */
+struct step_timing
+{
+    std::int64_t reducer = 0;
+    std::atomic<std::int64_t> propagation{-1};
+    std::atomic<std::int64_t> effects{-1};
+
+    std::int64_t total() const
+    {
+        return reducer + std::max<std::int64_t>(propagation, 0) +
+               std::max<std::int64_t>(effects, 0);
+    }
+
+    template <typename Archive>
+    void save(Archive& ar) const
+    {
+        ar(cereal::make_nvp("reducer", reducer),
+           cereal::make_nvp("propagation", propagation.load()),
+           cereal::make_nvp("effects", effects.load()));
+    }
+};
+
+/*!
+ * Totals of the `step_timing` of a `debugger` history, and the cursors of
+ * its slowest steps, slowest first.
+ */
+struct timing_summary
+{
+    bool enabled                     = false;
+    std::size_t steps                = 0;
+    std::int64_t reducer             = 0;
+    std::int64_t propagation         = 0;
+    std::int64_t effects             = 0;
+    std::vector<std::size_t> slowest = {};
+};
+
+LAGER_CEREAL_STRUCT(
+    timing_summary,
+    (enabled)(steps)(reducer)(propagation)(effects)(slowest));
+
+/*!
+ * Enhances a store with an undoable history of the actions and the models
+ * they produced.  The history is kept in immer containers using the given
+ * `MemoryPolicy`, see `lager/memory_policy.hpp` for some presets.
+ */
+template <typename Action,
+          typename Model,
+          typename Deps,
+          typename MemoryPolicy = immer::default_memory_policy>
 struct debugger
 {
-    using base_action = Action;
-    using base_model  = Model;
-    using deps_t      = Deps;
+    using base_action   = Action;
+    using base_model    = Model;
+    using deps_t        = Deps;
+    using memory_policy = MemoryPolicy;
 
     using cursor_t = std::size_t;
+    using index_t  = search_index<Action, MemoryPolicy>;
 
     struct goto_action
     {
@@ -51,27 +115,37 @@ struct debugger
     {};
     struct resume_action
     {};
+    struct timing_action
+    {
+        bool enabled;
+    };
 
     using action = std::variant<Action,
                                 goto_action,
                                 undo_action,
                                 redo_action,
                                 pause_action,
-                                resume_action>;
+                                resume_action,
+                                timing_action>;
 
     struct step
     {
         Action action;
         Model model;
+        std::shared_ptr<step_timing> timing = nullptr;
     };
 
     struct model
     {
         cursor_t cursor = {};
         bool paused     = {};
+        bool timing     = {};
         Model init;
-        immer::vector<step> history   = {};
-        immer::vector<Action> pending = {};
+        immer::vector<step, MemoryPolicy> history   = {};
+        immer::vector<Action, MemoryPolicy> pending = {};
+        index_t index                               = {};
+        // Grows whenever `history` or `pending` are changed.
+        std::size_t revision = {};
 
         model() = default;
         model(Model i)
@@ -92,8 +166,56 @@ struct debugger
 
         std::size_t summary() const { return history.size(); }
 
+        std::shared_ptr<const step_timing> lookup_timing(cursor_t cursor) const
+        {
+            if (cursor > history.size())
+                throw std::runtime_error{"bad cursor"};
+            return cursor == 0 ? nullptr : history[cursor - 1].timing;
+        }
+
+        timing_summary summarize_timing(std::size_t slowest = 10) const
+        {
+            auto r     = timing_summary{timing};
+            auto steps = std::vector<std::pair<std::int64_t, cursor_t>>{};
+            auto pos   = cursor_t{};
+            for (auto&& s : history) {
+                ++pos;
+                if (!s.timing)
+                    continue;
+                ++r.steps;
+                r.reducer += s.timing->reducer;
+                r.propagation +=
+                    std::max<std::int64_t>(s.timing->propagation, 0);
+                r.effects += std::max<std::int64_t>(s.timing->effects, 0);
+                steps.emplace_back(s.timing->total(), pos);
+            }
+            auto n = std::min(slowest, steps.size());
+            std::partial_sort(
+                steps.begin(),
+                steps.begin() + n,
+                steps.end(),
+                [](auto& a, auto& b) { return a.first > b.first; });
+            for (auto i = std::size_t{}; i < n; ++i)
+                r.slowest.push_back(steps[i].second);
+            return r;
+        }
+
         operator const Model&() const { return lookup(cursor).second; }
 
+        // Otherwise they would be compared via the conversion above, and
+        // changes only to the debugger state, like `paused` or `timing`,
+        // would not be propagated.  The history is compared by `revision`,
+        // which is cheap and does not need `Model` to be comparable.
+        friend bool operator==(const model& a, const model& b)
+        {
+            return a.cursor == b.cursor && a.paused == b.paused &&
+                   a.timing == b.timing && a.revision == b.revision;
+        }
+        friend bool operator!=(const model& a, const model& b)
+        {
+            return !(a == b);
+        }
+
         friend decltype(auto) unwrap(const model& m)
         {
             return unwrap(static_cast<const Model&>(m));
@@ -110,18 +232,39 @@ struct debugger
                 [&](Action act) -> result_t {
                     if (m.paused) {
                         m.pending = m.pending.push_back(act);
+                        ++m.revision;
                         return {m, noop};
                     } else {
-                        auto eff   = effect<action, deps_t>{noop};
-                        auto state = invoke_reducer<deps_t>(
+                        using clock = std::chrono::steady_clock;
+                        auto timing = m.timing ? std::make_shared<step_timing>()
+                                               : nullptr;
+                        auto eff    = effect<action, deps_t>{noop};
+                        auto start  = clock::now();
+                        auto state  = invoke_reducer<deps_t>(
                             reducer,
                             m,
                             act,
                             [&](auto&& e) { eff = LAGER_FWD(e); },
                             [] {});
+                        if (timing) {
+                            auto reduced    = clock::now();
+                            timing->reducer = nanoseconds(reduced - start);
+                            eff = [eff, timing, reduced](auto&& ctx) {
+                                auto start = clock::now();
+                                timing->propagation =
+                                    nanoseconds(start - reduced);
+                                eff(ctx);
+                                timing->effects =
+                                    nanoseconds(clock::now() - start);
+                            };
+                        }
+                        if (m.cursor < m.history.size())
+                            m.index = m.index.truncate(m.cursor);
                         m.history = m.history.take(m.cursor).push_back(
-                            {act, std::move(state)});
+                            {act, std::move(state), std::move(timing)});
                         m.cursor = m.history.size();
+                        m.index  = m.index.add(m.cursor, act);
+                        ++m.revision;
                         return {m, eff};
                     }
                 },
@@ -151,6 +294,7 @@ struct debugger
                     auto pending     = m.pending;
                     m.paused         = false;
                     m.pending        = {};
+                    ++m.revision;
                     std::tie(m, eff) = immer::accumulate(
                         pending,
                         std::pair{m, eff},
@@ -162,6 +306,10 @@ struct debugger
                         });
                     return {m, sequence(resume_eff, eff)};
                 },
+                [&](timing_action act) -> result_t {
+                    m.timing = act.enabled;
+                    return {m, noop};
+                },
             },
             act);
     }
@@ -172,33 +320,52 @@ struct debugger
         serv.view(m);
     }
 
+    template <typename Duration>
+    static std::int64_t nanoseconds(Duration d)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    }
+
     LAGER_CEREAL_NESTED_STRUCT(undo_action);
     LAGER_CEREAL_NESTED_STRUCT(redo_action);
     LAGER_CEREAL_NESTED_STRUCT(pause_action);
     LAGER_CEREAL_NESTED_STRUCT(resume_action);
+    LAGER_CEREAL_NESTED_STRUCT(timing_action, (enabled));
     LAGER_CEREAL_NESTED_STRUCT(goto_action, (cursor));
     LAGER_CEREAL_NESTED_STRUCT(model, (cursor)(paused)(init)(history));
     LAGER_CEREAL_NESTED_STRUCT(step, (action)(model));
 };
 
-template <template <class, class, class> class Debugger = debugger,
-          typename Server>
-auto with_debugger(Server& serv)
+/*!
+ * Store enhancer that records the history of the store in a `Debugger`, that
+ * is exposed via the `Server`.  The `MemoryPolicy`, if given, is passed to the
+ * debugger for its history.  The `keys`, made with `search_key()`, are added
+ * to the search index of the debugger.
+ */
+template <template <class...> class Debugger = debugger,
+          typename... MemoryPolicy,
+          typename Server,
+          typename... KeyFns>
+auto with_debugger(Server& serv, search_key_t<KeyFns>... keys)
 {
-    return [&](auto next) {
-        return [&serv, next](auto action,
-                             auto&& model,
-                             auto&& reducer,
-                             auto&& loop,
-                             auto&& deps) {
+    return [&serv, keys...](auto next) {
+        return [&serv, next, keys...](auto action,
+                                      auto&& model,
+                                      auto&& reducer,
+                                      auto&& loop,
+                                      auto&& deps) {
             using action_t   = typename decltype(action)::type;
             using model_t    = std::decay_t<decltype(model)>;
             using deps_t     = std::decay_t<decltype(deps)>;
-            using debugger_t = Debugger<action_t, model_t, deps_t>;
+            using debugger_t =
+                Debugger<action_t, model_t, deps_t, MemoryPolicy...>;
             auto& handle     = serv.enable(debugger_t{});
-            auto store       = next(
+            auto init        = typename debugger_t::model{LAGER_FWD(model)};
+            if constexpr (sizeof...(keys) > 0)
+                init.index = init.index.with_keys(keys...);
+            auto store = next(
                 type_<typename debugger_t::action>{},
-                typename debugger_t::model{LAGER_FWD(model)},
+                std::move(init),
                 [reducer = LAGER_FWD(reducer)](auto&& model, auto&& action) {
                     return debugger_t::update(
                         reducer, LAGER_FWD(model), LAGER_FWD(action));
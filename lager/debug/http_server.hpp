@@ -15,15 +15,16 @@
 #include <lager/context.hpp>
 #include <lager/reader.hpp>
 
-#include <cereal/archives/json.hpp>
 #include <cereal/cereal.hpp>
-#include <cereal/types/optional.hpp>
-#include <lager/debug/cereal/variant_with_name.hpp>
+#include <lager/debug/cereal/json_writer.hpp>
 
 #include <httpserver.hpp>
 
+#include <zug/meta/detected.hpp>
+
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <vector>
@@ -39,6 +40,20 @@ bool ends_with(const std::string& str, const std::string& ending)
                str.length() - ending.length(), ending.length(), ending) == 0;
 }
 
+template <typename Debugger>
+using debugger_index_t = typename Debugger::index_t;
+
+template <typename Debugger>
+using debugger_timing_action_t = typename Debugger::timing_action;
+
+//! Reused by the requests served by a thread, so it only grows once
+inline std::string& json_buffer()
+{
+    thread_local auto buffer = std::string{};
+    buffer.clear();
+    return buffer;
+}
+
 } // namespace detail
 
 class http_debug_server
@@ -59,6 +74,14 @@ public:
         using context_t   = context<action>;
         using reader_t    = reader<model>;
 
+        //! Whether the debugger keeps a `search_index`, like `debugger`
+        static constexpr bool has_search =
+            zug::meta::is_detected<detail::debugger_index_t, Debugger>::value;
+        //! Whether the debugger can record `step_timing`, like `debugger`
+        static constexpr bool has_timing =
+            zug::meta::is_detected<detail::debugger_timing_action_t,
+                                   Debugger>::value;
+
         void set_context(context_t ctx) { context_ = std::move(ctx); }
         void set_reader(reader_t data) { data_ = std::move(data); }
         std::string const& resources_path() { return resources_path_; }
@@ -116,17 +139,19 @@ public:
             using resource_t::resource_t;
             response_t render_GET(const request_t& req) override
             {
-                auto m = this->self.get_model_();
-                auto s = std::ostringstream{};
+                auto m  = this->self.get_model_();
+                auto& s = detail::json_buffer();
                 {
-                    auto a = cereal::JSONOutputArchive{s};
+                    auto a = json_writer{s};
                     a(cereal::make_nvp("program", this->self.program_),
                       cereal::make_nvp("summary", m.summary()),
                       cereal::make_nvp("cursor", m.cursor),
                       cereal::make_nvp("paused", m.paused));
+                    if constexpr (has_timing)
+                        a(cereal::make_nvp("timing", m.summarize_timing()));
                 }
                 return std::make_shared<httpserver::string_response>(
-                    s.str(), 200, "text/json");
+                    s, 200, "text/json");
             }
         } root_resource_ = {*this};
 
@@ -135,21 +160,117 @@ public:
             using resource_t::resource_t;
             response_t render_GET(const request_t& req) override
             {
-                auto m = this->self.get_model_();
-                auto s = std::ostringstream{};
+                auto m  = this->self.get_model_();
+                auto& s = detail::json_buffer();
                 {
                     auto cursor = std::stoul(req.get_arg("cursor"));
                     auto result = m.lookup(cursor);
-                    auto a      = cereal::JSONOutputArchive{s};
+                    auto a      = json_writer{s};
                     if (result.first)
                         a(cereal::make_nvp("action", *result.first));
                     a(cereal::make_nvp("model", result.second));
+                    if constexpr (has_timing) {
+                        if (auto timing = m.lookup_timing(cursor))
+                            a(cereal::make_nvp("timing", *timing));
+                    }
                 }
                 return std::make_shared<httpserver::string_response>(
-                    s.str(), 200, "text/json");
+                    s, 200, "text/json");
             }
         } step_resource_ = {*this};
 
+        static std::size_t
+        arg_or_(const request_t& req, const char* name, std::size_t def)
+        {
+            std::string arg = req.get_arg(name);
+            return arg.empty() ? def : std::stoul(arg);
+        }
+
+        static response_t not_found_()
+        {
+            return std::make_shared<httpserver::string_response>("", 404);
+        }
+
+        // The search and timing resources are only registered when the
+        // debugger supports them, but being virtual they are instantiated
+        // anyway, so their bodies are guarded too.
+
+        template <typename Positions>
+        static response_t search_response_(const request_t& req,
+                                           const Positions& ps)
+        {
+            using index_t = typename Debugger::index_t;
+            auto from     = arg_or_(req, "from", 0);
+            auto limit    = arg_or_(req, "limit", 1000);
+            auto& s       = detail::json_buffer();
+            {
+                auto a = json_writer{s};
+                a(cereal::make_nvp("total", ps.size()),
+                  cereal::make_nvp("steps", index_t::page(ps, from, limit)));
+            }
+            return std::make_shared<httpserver::string_response>(
+                s, 200, "text/json");
+        }
+
+        struct : resource_t
+        {
+            using resource_t::resource_t;
+            response_t render_GET(const request_t& req) override
+            {
+                if constexpr (has_search) {
+                    auto m     = this->self.get_model_();
+                    auto types = std::map<std::string, std::size_t>{};
+                    auto keys  = std::map<std::string, std::size_t>{};
+                    for (auto&& [type, ps] : m.index.types)
+                        types[type] = ps.size();
+                    for (auto&& [name, table] : m.index.keys)
+                        keys[name] = table.size();
+                    auto& s = detail::json_buffer();
+                    {
+                        auto a = json_writer{s};
+                        a(cereal::make_nvp("types", types),
+                          cereal::make_nvp("keys", keys));
+                    }
+                    return std::make_shared<httpserver::string_response>(
+                        s, 200, "text/json");
+                } else {
+                    return not_found_();
+                }
+            }
+        } search_resource_ = {*this};
+
+        struct : resource_t
+        {
+            using resource_t::resource_t;
+            response_t render_GET(const request_t& req) override
+            {
+                if constexpr (has_search) {
+                    auto m = this->self.get_model_();
+                    return search_response_(
+                        req, m.index.find_type(req.get_arg("type")));
+                } else {
+                    return not_found_();
+                }
+            }
+        } search_type_resource_ = {*this};
+
+        struct : resource_t
+        {
+            using resource_t::resource_t;
+            response_t render_GET(const request_t& req) override
+            {
+                if constexpr (has_search) {
+                    auto m = this->self.get_model_();
+                    return search_response_(
+                        req,
+                        m.index.find_key(req.get_arg("name"),
+                                         req.get_arg("key")));
+                } else {
+                    return not_found_();
+                }
+            }
+        } search_key_resource_ = {*this};
+
         struct : resource_t
         {
             using resource_t::resource_t;
@@ -203,6 +324,24 @@ public:
             }
         } resume_resource_ = {*this};
 
+        struct : resource_t
+        {
+            using resource_t::resource_t;
+            response_t render_POST(const request_t& req) override
+            {
+                if constexpr (has_timing) {
+                    std::string enabled = req.get_arg("enabled");
+                    this->self.context_.dispatch(
+                        typename Debugger::timing_action{enabled == "1" ||
+                                                         enabled == "true"});
+                    return std::make_shared<httpserver::string_response>("",
+                                                                         200);
+                } else {
+                    return not_found_();
+                }
+            }
+        } timing_resource_ = {*this};
+
         struct : resource_t
         {
             using resource_t::resource_t;
@@ -252,6 +391,17 @@ public:
         server_.register_resource("/api/redo", &hdl.redo_resource_);
         server_.register_resource("/api/pause", &hdl.pause_resource_);
         server_.register_resource("/api/resume", &hdl.resume_resource_);
+        if constexpr (handle_t::has_timing) {
+            server_.register_resource("/api/timing/{enabled}",
+                                      &hdl.timing_resource_);
+        }
+        if constexpr (handle_t::has_search) {
+            server_.register_resource("/api/search/type/{type}",
+                                      &hdl.search_type_resource_);
+            server_.register_resource("/api/search/key/{name}/{key}",
+                                      &hdl.search_key_resource_);
+            server_.register_resource("/api/search", &hdl.search_resource_);
+        }
         server_.register_resource("/api/?", &hdl.root_resource_);
         server_.register_resource("/?.*", &hdl.gui_resource_);
         handle_ = std::move(hdl_);
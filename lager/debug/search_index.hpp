@@ -0,0 +1,210 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/debug/cereal/variant_with_name.hpp>
+
+#include <immer/map.hpp>
+#include <immer/memory_policy.hpp>
+#include <immer/vector.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace lager {
+
+namespace detail {
+
+template <typename T>
+struct is_search_variant : std::false_type
+{};
+template <typename... Ts>
+struct is_search_variant<std::variant<Ts...>> : std::true_type
+{};
+
+} // namespace detail
+
+/*!
+ * Extracts a searchable key from the actions recorded by a debugger, see
+ * `search_key()` and `with_debugger()`.
+ */
+template <typename Fn>
+struct search_key_t
+{
+    std::string name;
+    Fn fn;
+};
+
+/*!
+ * Makes the debugger index the recorded actions by the result of `fn`, under
+ * the given `name`.  `fn` takes an action and returns a `std::string`, or a
+ * `std::optional<std::string>` that is empty for actions with no key.
+ */
+template <typename Fn>
+search_key_t<Fn> search_key(std::string name, Fn fn)
+{
+    return {std::move(name), std::move(fn)};
+}
+
+/*!
+ * Persistent index of the steps of a debugger history.  Steps are indexed by
+ * the type of their action (the type held by the variant, if the action is
+ * one) and by the keys produced by the user supplied `search_key()`s.  The
+ * positions of every type and key are kept sorted, so they can be queried in
+ * logarithmic time and paginated.
+ */
+template <typename Action, typename MemoryPolicy = immer::default_memory_policy>
+struct search_index
+{
+    using cursor_t    = std::size_t;
+    using positions_t = immer::vector<cursor_t, MemoryPolicy>;
+    using table_t     = immer::map<std::string,
+                               positions_t,
+                               std::hash<std::string>,
+                               std::equal_to<std::string>,
+                               MemoryPolicy>;
+    using key_tables_t = immer::map<std::string,
+                                    table_t,
+                                    std::hash<std::string>,
+                                    std::equal_to<std::string>,
+                                    MemoryPolicy>;
+    using key_fn_t = std::function<std::optional<std::string>(const Action&)>;
+    using key_fns_t = std::vector<std::pair<std::string, key_fn_t>>;
+
+    table_t types;
+    key_tables_t keys;
+    std::shared_ptr<const key_fns_t> key_fns = {};
+
+    /*!
+     * Returns the name under which steps with action `act` are indexed.
+     */
+    static const std::string& type_name(const Action& act)
+    {
+        if constexpr (detail::is_search_variant<Action>::value)
+            return std::visit(
+                [](auto& x) -> const std::string& {
+                    return cereal::detail::get_type_name<
+                        std::decay_t<decltype(x)>>();
+                },
+                act);
+        else
+            return cereal::detail::get_type_name<Action>();
+    }
+
+    /*!
+     * Returns a copy of the index that also indexes the actions by the given
+     * `search_key()`s.  Only steps added after this are indexed by them.
+     */
+    template <typename... Fns>
+    search_index with_keys(search_key_t<Fns>... ks) const
+    {
+        auto fns = key_fns ? *key_fns : key_fns_t{};
+        (fns.emplace_back(std::move(ks.name), std::move(ks.fn)), ...);
+        auto r    = *this;
+        r.key_fns = std::make_shared<const key_fns_t>(std::move(fns));
+        return r;
+    }
+
+    /*!
+     * Indexes the step at position `pos`, that must be greater than the
+     * positions of the steps indexed so far.
+     */
+    search_index add(cursor_t pos, const Action& act) const
+    {
+        auto r  = *this;
+        r.types = add_to(types, type_name(act), pos);
+        if (key_fns) {
+            for (auto& [name, fn] : *key_fns) {
+                if (auto key = fn(act)) {
+                    auto table = keys.find(name);
+                    r.keys     = r.keys.set(
+                        name, add_to(table ? *table : table_t{}, *key, pos));
+                }
+            }
+        }
+        return r;
+    }
+
+    /*!
+     * Removes the steps with positions greater than `pos`.
+     */
+    search_index truncate(cursor_t pos) const
+    {
+        auto r  = *this;
+        r.types = truncate_table(types, pos);
+        for (auto& [name, table] : keys)
+            r.keys = r.keys.set(name, truncate_table(table, pos));
+        return r;
+    }
+
+    /*!
+     * Returns the positions of the steps with actions of the given type.
+     */
+    positions_t find_type(const std::string& type) const
+    {
+        auto p = types.find(type);
+        return p ? *p : positions_t{};
+    }
+
+    /*!
+     * Returns the positions of the steps whose action had `key` for the
+     * `search_key()` called `name`.
+     */
+    positions_t find_key(const std::string& name, const std::string& key) const
+    {
+        auto table = keys.find(name);
+        auto p     = table ? table->find(key) : nullptr;
+        return p ? *p : positions_t{};
+    }
+
+    /*!
+     * Returns up to `limit` positions from `ps` that are not less than
+     * `from`, for paginating the results of the queries above.
+     */
+    static std::vector<cursor_t>
+    page(const positions_t& ps, cursor_t from, std::size_t limit)
+    {
+        auto first = std::lower_bound(ps.begin(), ps.end(), from);
+        auto count = std::min<std::size_t>(limit, ps.end() - first);
+        return {first, first + count};
+    }
+
+private:
+    static table_t
+    add_to(const table_t& table, const std::string& key, cursor_t pos)
+    {
+        auto p = table.find(key);
+        return table.set(key, (p ? *p : positions_t{}).push_back(pos));
+    }
+
+    static table_t truncate_table(const table_t& table, cursor_t pos)
+    {
+        auto r = table;
+        for (auto& [key, ps] : table) {
+            if (ps.back() <= pos)
+                continue;
+            auto n = std::upper_bound(ps.begin(), ps.end(), pos) - ps.begin();
+            r      = n ? r.set(key, ps.take(n)) : r.erase(key);
+        }
+        return r;
+    }
+};
+
+} // namespace lager
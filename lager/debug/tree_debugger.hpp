@@ -17,6 +17,7 @@
 
 #include <immer/algorithm.hpp>
 #include <immer/box.hpp>
+#include <immer/memory_policy.hpp>
 #include <immer/vector.hpp>
 #include <immer/vector_transient.hpp>
 
@@ -30,20 +31,42 @@
 
 namespace lager {
 
-template <typename Action, typename Model, typename Deps>
+/*!
+ * Like `debugger`, but actions dispatched after going back in time start new
+ * branches, instead of discarding the undone steps.
+ */
+template <typename Action,
+          typename Model,
+          typename Deps,
+          typename MemoryPolicy = immer::default_memory_policy>
 struct tree_debugger
 {
-    using base_action = Action;
-    using base_model  = Model;
-    using deps_t      = Deps;
+    using base_action   = Action;
+    using base_model    = Model;
+    using deps_t        = Deps;
+    using memory_policy = MemoryPolicy;
+
+    template <typename T>
+    using vector_t = immer::vector<T, MemoryPolicy>;
+    template <typename T>
+    using box_t = immer::box<T, MemoryPolicy>;
 
     struct pos_t
     {
         std::size_t branch;
         std::size_t step;
+
+        friend bool operator==(const pos_t& a, const pos_t& b)
+        {
+            return a.branch == b.branch && a.step == b.step;
+        }
+        friend bool operator!=(const pos_t& a, const pos_t& b)
+        {
+            return !(a == b);
+        }
     };
 
-    using cursor_t = immer::vector<pos_t>;
+    using cursor_t = vector_t<pos_t>;
 
     struct goto_action
     {
@@ -66,19 +89,19 @@ struct tree_debugger
                                 resume_action>;
 
     struct step;
-    using history = immer::vector<immer::box<step>>;
+    using history = vector_t<box_t<step>>;
 
     struct step
     {
         Action action;
         Model model;
-        immer::vector<history> branches;
+        vector_t<history> branches;
     };
 
     struct summary_step_t;
 
-    using summary_history_t = immer::vector<immer::box<summary_step_t>>;
-    using summary_t         = immer::vector<summary_history_t>;
+    using summary_history_t = vector_t<box_t<summary_step_t>>;
+    using summary_t         = vector_t<summary_history_t>;
 
     struct summary_step_t
     {
@@ -91,8 +114,10 @@ struct tree_debugger
         cursor_t cursor = {};
         bool paused     = {};
         Model init;
-        immer::vector<history> branches = {};
-        immer::vector<Action> pending   = {};
+        vector_t<history> branches = {};
+        vector_t<Action> pending   = {};
+        // Grows whenever `branches` or `pending` are changed.
+        std::size_t revision = {};
 
         model() = default;
         model(Model i)
@@ -101,7 +126,7 @@ struct tree_debugger
 
         using lookup_result = std::pair<std::optional<Action>, const Model&>;
 
-        lookup_result do_lookup(const immer::vector<history>& branches,
+        lookup_result do_lookup(const vector_t<history>& branches,
                                 const cursor_t& cursor,
                                 std::size_t cursor_index) const
         {
@@ -124,8 +149,8 @@ struct tree_debugger
                                   : do_lookup(branches, cursor, 0);
         }
 
-        std::pair<immer::vector<history>, cursor_t>
-        do_append(const immer::vector<history>& branches,
+        std::pair<vector_t<history>, cursor_t>
+        do_append(const vector_t<history>& branches,
                   const cursor_t& cursor,
                   std::size_t cursor_index,
                   const Action& act,
@@ -166,6 +191,7 @@ struct tree_debugger
         void append(const Action& act, const Model& m)
         {
             using namespace std;
+            ++revision;
             if (cursor.empty()) {
                 branches = branches.push_back({step{act, m, {}}});
                 cursor   = {{branches.size() - 1, 0}};
@@ -184,7 +210,7 @@ struct tree_debugger
             }
         }
 
-        summary_t do_summary(const immer::vector<history>& branches) const
+        summary_t do_summary(const vector_t<history>& branches) const
         {
             auto result = summary_t{}.transient();
             immer::for_each(branches, [&](auto&& history) {
@@ -208,6 +234,18 @@ struct tree_debugger
 
         operator const Model&() const { return lookup(cursor).second; }
 
+        // Like for the `debugger`, compares only the state of the debugger,
+        // so changes to the cursor or `paused` alone are propagated.
+        friend bool operator==(const model& a, const model& b)
+        {
+            return a.cursor == b.cursor && a.paused == b.paused &&
+                   a.revision == b.revision;
+        }
+        friend bool operator!=(const model& a, const model& b)
+        {
+            return !(a == b);
+        }
+
         friend decltype(auto) unwrap(const model& m)
         {
             return unwrap(static_cast<const Model&>(m));
@@ -224,6 +262,7 @@ struct tree_debugger
                 [&](Action act) -> result_t {
                     if (m.paused) {
                         m.pending = m.pending.push_back(act);
+                        ++m.revision;
                         return m;
                     } else {
                         auto eff   = effect<action, deps_t>{noop};
@@ -268,6 +307,7 @@ struct tree_debugger
                     auto pending     = m.pending;
                     m.paused         = false;
                     m.pending        = {};
+                    ++m.revision;
                     std::tie(m, eff) = immer::accumulate(
                         pending,
                         result_t{m, eff},
@@ -0,0 +1,100 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/diff.hpp>
+#include <lager/detail/nodes.hpp>
+
+#include <zug/meta/pack.hpp>
+#include <zug/meta/value_type.hpp>
+
+#include <memory>
+#include <tuple>
+#include <utility>
+
+namespace lager {
+namespace detail {
+
+/*!
+ * Node whose value is an aggregate over the elements of the container in its
+ * parent.  Instead of folding the whole container on every change, it
+ * computes the changes with respect to the parent value that was folded last,
+ * using `changes_traits`, and only removes from the aggregate the elements
+ * that were removed or changed and adds those that were added or changed.
+ */
+template <typename Aggregator, typename Parent>
+class aggregate_reader_node
+    : public inner_node<typename Aggregator::value_type,
+                        zug::meta::pack<Parent>,
+                        reader_node>
+{
+    using base_t         = inner_node<typename Aggregator::value_type,
+                              zug::meta::pack<Parent>,
+                              reader_node>;
+    using parent_value_t = zug::meta::value_t<Parent>;
+    using changes_t      = changes_traits<parent_value_t>;
+
+    Aggregator aggregator_;
+    parent_value_t folded_;
+
+    static auto fold(const Aggregator& agg, const parent_value_t& container)
+    {
+        auto value = agg.init;
+        for (auto&& x : container)
+            value = agg.add(std::move(value), x);
+        return value;
+    }
+
+public:
+    using value_type = typename base_t::value_type;
+
+    aggregate_reader_node(Aggregator agg,
+                          std::tuple<std::shared_ptr<Parent>> parents)
+        : base_t{fold(agg, std::get<0>(parents)->current()),
+                 std::move(parents)}
+        , aggregator_{std::move(agg)}
+        , folded_{std::get<0>(this->parents())->current()}
+    {}
+
+    void recompute() final
+    {
+        const auto& container = std::get<0>(this->parents())->current();
+        auto changes          = changes_t::make(folded_, container);
+        if (changes.empty())
+            return;
+        auto value = this->current();
+        for (auto x : changes.removed)
+            value = aggregator_.remove(std::move(value), *x);
+        for (auto [x, y] : changes.changed) {
+            value = aggregator_.remove(std::move(value), *x);
+            value = aggregator_.add(std::move(value), *y);
+        }
+        for (auto x : changes.added)
+            value = aggregator_.add(std::move(value), *x);
+        folded_ = container;
+        this->push_down(std::move(value));
+    }
+};
+
+template <typename Aggregator, typename Parent>
+auto make_aggregate_reader_node(Aggregator&& agg,
+                                std::tuple<std::shared_ptr<Parent>> parents)
+{
+    return link_to_parents(
+        std::make_shared<
+            aggregate_reader_node<std::decay_t<Aggregator>, Parent>>(
+            std::forward<Aggregator>(agg), std::move(parents)));
+}
+
+} // namespace detail
+} // namespace lager
@@ -0,0 +1,59 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+namespace lager {
+namespace detail {
+
+/*!
+ * Time budget for the notifications happening in the current thread.  Low
+ * priority watchers notified once the budget is exhausted are deferred.
+ *
+ * @see lager/budget.hpp
+ */
+struct notify_budget_base
+{
+    using clock_t = std::chrono::steady_clock;
+
+    notify_budget_base(clock_t::duration budget)
+        : deadline_{clock_t::now() + budget}
+        , previous_{current()}
+    {
+        current() = this;
+    }
+
+    notify_budget_base(const notify_budget_base&) = delete;
+    notify_budget_base& operator=(const notify_budget_base&) = delete;
+
+    virtual ~notify_budget_base() { current() = previous_; }
+
+    bool expired() const { return clock_t::now() >= deadline_; }
+
+    virtual void defer(std::function<void()> fn) = 0;
+
+    static notify_budget_base*& current()
+    {
+        static thread_local notify_budget_base* budget = nullptr;
+        return budget;
+    }
+
+private:
+    clock_t::time_point deadline_;
+    notify_budget_base* previous_;
+};
+
+} // namespace detail
+} // namespace lager
@@ -0,0 +1,69 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <memory>
+
+namespace lager {
+
+/*!
+ * Customization point to compute a change set between two versions of a value
+ * of type `T`.  Specializations must provide a `type` with the change set and
+ * a static `make(old, new)` function computing it.
+ *
+ * @see lager/diff.hpp for the specializations for Immer containers.
+ */
+template <typename T>
+struct changes_traits;
+
+namespace detail {
+
+/*!
+ * Describes the transition of a node from an old value to a new one.  A
+ * single instance is shared by all the diff observers of a node during a
+ * notification, such that the change set, when requested, is computed only
+ * once.
+ */
+template <typename T>
+class value_diff
+{
+public:
+    value_diff(const T& old_value, const T& new_value)
+        : old_{old_value}
+        , new_{new_value}
+    {}
+
+    value_diff(const value_diff&) = delete;
+    value_diff& operator=(const value_diff&) = delete;
+
+    const T& old_value() const { return old_; }
+    const T& new_value() const { return new_; }
+
+    template <typename Traits = changes_traits<T>>
+    const typename Traits::type& changes() const
+    {
+        using changes_t = typename Traits::type;
+        if (!changes_)
+            changes_ =
+                std::make_shared<const changes_t>(Traits::make(old_, new_));
+        return *static_cast<const changes_t*>(changes_.get());
+    }
+
+private:
+    const T& old_;
+    const T& new_;
+    mutable std::shared_ptr<const void> changes_;
+};
+
+} // namespace detail
+} // namespace lager
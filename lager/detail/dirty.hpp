@@ -0,0 +1,247 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace lager {
+namespace detail {
+
+template <typename Key>
+constexpr bool is_path_key_v =
+    std::is_integral_v<Key> || std::is_member_object_pointer_v<Key>;
+
+/*!
+ * Type erased step in the path to a part of a model: either an index or a
+ * pointer to data member.  Indices of any integral type compare equal.
+ */
+struct path_key
+{
+    const std::type_info* type = nullptr;
+    std::uintptr_t value[2]    = {};
+
+    bool operator==(const path_key& k) const
+    {
+        return *type == *k.type && value[0] == k.value[0] &&
+               value[1] == k.value[1];
+    }
+    bool operator!=(const path_key& k) const { return !(*this == k); }
+};
+
+template <typename Key>
+path_key make_path_key(Key k)
+{
+    static_assert(is_path_key_v<Key>, "paths contain indices or members");
+    auto r = path_key{};
+    if constexpr (std::is_integral_v<Key>) {
+        r.type     = &typeid(std::size_t);
+        r.value[0] = static_cast<std::uintptr_t>(k);
+    } else {
+        static_assert(sizeof(Key) <= sizeof(r.value),
+                      "unsupported pointer to member representation");
+        r.type = &typeid(Key);
+        std::memcpy(r.value, &k, sizeof(Key));
+    }
+    return r;
+}
+
+using dirty_path = std::vector<path_key>;
+
+/*!
+ * Paths to the parts of a model that were updated since it was last sent
+ * down.  When not all updates were recorded, every part is considered dirty.
+ */
+class dirty_set
+{
+public:
+    bool all() const { return all_; }
+
+    void mark_all()
+    {
+        all_ = true;
+        paths_.clear();
+    }
+
+    void clear()
+    {
+        all_ = false;
+        paths_.clear();
+    }
+
+    void add(dirty_path path)
+    {
+        if (!all_)
+            paths_.push_back(std::move(path));
+    }
+
+    /*!
+     * Whether the part at `path` may have changed, that is, whether an
+     * updated path is a prefix of it or the other way around.
+     */
+    bool intersects(const dirty_path& path) const
+    {
+        return all_ ||
+               std::any_of(paths_.begin(), paths_.end(), [&](auto& p) {
+                   auto n = std::min(p.size(), path.size());
+                   return std::equal(p.begin(), p.begin() + n, path.begin());
+               });
+    }
+
+private:
+    bool all_ = false;
+    std::vector<dirty_path> paths_;
+};
+
+/*!
+ * Path to the part viewed by a node, when its parent knows which of its parts
+ * are updated.  Otherwise, the node is always considered dirty.
+ */
+class tracked_part
+{
+public:
+    tracked_part() = default;
+
+    template <typename Parent>
+    tracked_part(const Parent& parent, const dirty_path& keys)
+    {
+        if (auto p = parent.tracked_path()) {
+            path_ = *p;
+            path_->insert(path_->end(), keys.begin(), keys.end());
+        }
+    }
+
+    const dirty_path* path() const { return path_ ? &*path_ : nullptr; }
+
+    template <typename Parent>
+    const dirty_set* dirty_paths(const Parent& parent) const
+    {
+        return path_ ? parent.dirty_paths() : nullptr;
+    }
+
+    /*!
+     * Whether the part is known not to have been updated.
+     */
+    template <typename Parent>
+    bool clean(const Parent& parent) const
+    {
+        auto dirty = dirty_paths(parent);
+        return dirty && !dirty->intersects(*path_);
+    }
+
+private:
+    std::optional<dirty_path> path_;
+};
+
+/*!
+ * Records into a `dirty_set` the updates done by a reducer in the current
+ * thread, while this object is alive.  Unless the reducer declares that it
+ * only updates its `Model` via `update_at()`, all parts are marked as dirty.
+ * Code running parts of the reducer in other threads must call `mark_all()`.
+ *
+ * @see lager/update_at.hpp
+ */
+class dirty_tracker
+{
+public:
+    dirty_tracker(dirty_set& dirty, const std::type_info& model)
+        : dirty_{dirty}
+        , model_{model}
+        , previous_{current()}
+    {
+        current() = this;
+    }
+
+    dirty_tracker(const dirty_tracker&) = delete;
+    dirty_tracker& operator=(const dirty_tracker&) = delete;
+
+    ~dirty_tracker()
+    {
+        current() = previous_;
+        if (!tracked_)
+            dirty_.mark_all();
+    }
+
+    template <typename Model>
+    void track()
+    {
+        tracked_ = tracked_ || typeid(Model) == model_;
+    }
+
+    /*!
+     * Marks all parts as dirty, for updates that can not be recorded, like
+     * those done in other threads.
+     */
+    void mark_all() { dirty_.mark_all(); }
+
+    template <typename Model>
+    void add(dirty_path path)
+    {
+        if (typeid(Model) == model_)
+            dirty_.add(std::move(path));
+        else
+            dirty_.mark_all();
+    }
+
+    static dirty_tracker*& current()
+    {
+        static thread_local dirty_tracker* tracker = nullptr;
+        return tracker;
+    }
+
+private:
+    dirty_set& dirty_;
+    const std::type_info& model_;
+    dirty_tracker* previous_;
+    bool tracked_ = false;
+};
+
+/*!
+ * Lens built by `operator[]` with an index or member, that remembers it so
+ * nodes using it can know the path to their part.
+ */
+template <typename Lens>
+struct keyed_lens
+{
+    Lens lens;
+    path_key key;
+
+    template <typename F>
+    auto operator()(F&& f) const
+    {
+        return lens(std::forward<F>(f));
+    }
+};
+
+template <typename Lens, typename Key>
+keyed_lens<Lens> make_keyed_lens(Lens lens, Key k)
+{
+    return {std::move(lens), make_path_key(k)};
+}
+
+template <typename Lens>
+struct is_keyed_lens : std::false_type
+{};
+
+template <typename Lens>
+struct is_keyed_lens<keyed_lens<Lens>> : std::true_type
+{};
+
+} // namespace detail
+} // namespace lager
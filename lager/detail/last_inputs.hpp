@@ -0,0 +1,63 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <zug/meta/detected.hpp>
+
+#include <any>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace lager {
+
+namespace detail {
+
+template <typename T>
+using input_equality_t =
+    decltype(std::declval<const T&>() == std::declval<const T&>());
+
+/*!
+ * Remembers the last inputs of a stateful transducer.  Nodes may recompute
+ * their value with the same inputs, for example when refreshed before
+ * sending a value up, or when reached through several parents that view the
+ * same root, and these must not count as new inputs.  Inputs that can not be
+ * compared always count as changed.
+ */
+class last_inputs
+{
+    std::any last_;
+
+public:
+    template <typename... Inputs>
+    bool changed(const Inputs&... is)
+    {
+        using tuple_t = std::tuple<std::decay_t<Inputs>...>;
+        if constexpr ((zug::meta::is_detected<input_equality_t,
+                                              std::decay_t<Inputs>>::value &&
+                       ...)) {
+            if (auto last = std::any_cast<tuple_t>(&last_)) {
+                if (*last == std::tie(is...))
+                    return false;
+                *last = std::tie(is...);
+            } else {
+                last_ = tuple_t{is...};
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace detail
+
+} // namespace lager
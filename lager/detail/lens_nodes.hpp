@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <lager/detail/dirty.hpp>
 #include <lager/detail/no_value.hpp>
 #include <lager/detail/nodes.hpp>
 #include <lager/util.hpp>
@@ -49,6 +50,15 @@ class lens_reader_node<Lens, zug::meta::pack<Parents...>, Base>
         zug::meta::pack<Parents...>,
         Base>;
 
+    // Lenses made by `operator[]` with an index or member on a single parent
+    // know the path to their part, so they can skip unaffected updates.
+    static constexpr bool keyed =
+        is_keyed_lens<Lens>::value && sizeof...(Parents) == 1;
+
+    tracked_part tracked_;
+
+    auto& parent() const { return *std::get<0>(this->parents()); }
+
 protected:
     Lens lens_;
 
@@ -58,12 +68,29 @@ public:
         : base_t{view(l, current_from(parents)),
                  std::forward<ParentsTuple>(parents)}
         , lens_{std::forward<Lens2>(l)}
-    {}
+    {
+        if constexpr (keyed)
+            tracked_ = tracked_part{parent(), dirty_path{lens_.key}};
+    }
 
     void recompute() final
     {
+        if constexpr (keyed) {
+            if (tracked_.clean(parent()))
+                return;
+        }
         this->push_down(view(lens_, current_from(this->parents())));
     }
+
+    const dirty_path* tracked_path() const final { return tracked_.path(); }
+
+    const dirty_set* dirty_paths() const final
+    {
+        if constexpr (keyed)
+            return tracked_.dirty_paths(parent());
+        else
+            return nullptr;
+    }
 };
 
 template <typename Lens        = zug::identity_t,
@@ -92,9 +119,14 @@ public:
 
     void send_up(value_type&& value) final
     {
-        this->refresh();
-        this->push_up(
-            set(this->lens_, current_from(this->parents()), std::move(value)));
+        // The values of the parents are moved into the lens, so uniquely
+        // owned parts are updated without copies.  This node's own value is
+        // not needed, so only the parents are refreshed.
+        this->refresh_parents();
+        auto restore = this->restoring_parents();
+        this->push_up(set(this->lens_,
+                          take_current_from(this->parents()),
+                          std::move(value)));
     }
 };
 
@@ -0,0 +1,191 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/nodes.hpp>
+
+#include <zug/meta/pack.hpp>
+#include <zug/meta/value_type.hpp>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace lager {
+
+namespace detail {
+
+template <typename Whole, typename Member, typename... Members>
+decltype(auto) get_member(const Whole& whole, Member m, Members... ms)
+{
+    if constexpr (sizeof...(Members) == 0)
+        return (whole.*m);
+    else
+        return get_member(whole.*m, ms...);
+}
+
+template <typename Whole, typename Part, typename Member, typename... Members>
+std::decay_t<Whole>
+set_member(Whole&& whole, Part&& part, Member m, Members... ms)
+{
+    auto r = std::forward<Whole>(whole);
+    if constexpr (sizeof...(Members) == 0)
+        r.*m = std::forward<Part>(part);
+    else
+        r.*m = set_member(std::move(r.*m), std::forward<Part>(part), ms...);
+    return r;
+}
+
+/*!
+ * Sequence of pointers to data members, that can be used to access a part of
+ * a value in place.  Like `lenses::attr` but, since the part lives inside the
+ * value, it can be viewed without copying it.
+ */
+template <typename... Members>
+struct member_path
+{
+    std::tuple<Members...> members;
+
+    template <typename Whole>
+    decltype(auto) get(const Whole& whole) const
+    {
+        auto get = [&](auto... ms) -> decltype(auto) {
+            return get_member(whole, ms...);
+        };
+        return std::apply(get, members);
+    }
+
+    template <typename Whole, typename Part>
+    auto set(Whole&& whole, Part&& part) const
+    {
+        return std::apply(
+            [&](auto... ms) {
+                return set_member(std::forward<Whole>(whole),
+                                  std::forward<Part>(part),
+                                  ms...);
+            },
+            members);
+    }
+
+    dirty_path keys() const
+    {
+        return std::apply(
+            [](auto... ms) { return dirty_path{make_path_key(ms)...}; },
+            members);
+    }
+
+    template <typename Member>
+    member_path<Members..., Member> then(Member m) const
+    {
+        return {std::tuple_cat(members, std::make_tuple(m))};
+    }
+};
+
+template <typename Path, typename Whole>
+using member_part_t =
+    std::decay_t<decltype(std::declval<Path>().get(std::declval<Whole>()))>;
+
+/*!
+ * Node focusing on a part of the value of its parent, reached via a
+ * `member_path`.  Instead of holding copies of the part, it views it inside
+ * the current and last values of the parent.
+ */
+template <typename Path, typename Parent, template <class> class Base>
+class member_node
+    : public inner_node<member_part_t<Path, zug::meta::value_t<Parent>>,
+                        zug::meta::pack<Parent>,
+                        Base>
+{
+    using base_t =
+        inner_node<member_part_t<Path, zug::meta::value_t<Parent>>,
+                   zug::meta::pack<Parent>,
+                   Base>;
+
+protected:
+    Path path_;
+    tracked_part tracked_;
+
+    auto& parent() const { return std::get<0>(this->parents()); }
+
+public:
+    member_node(Path path, std::tuple<std::shared_ptr<Parent>>&& parents)
+        : base_t{path.get(std::get<0>(parents)->current()),
+                 path.get(std::get<0>(parents)->last()),
+                 std::move(parents)}
+        , path_{std::move(path)}
+        , tracked_{*parent(), path_.keys()}
+    {}
+
+    void recompute() final
+    {
+        if (!tracked_.clean(*parent()))
+            this->push_down_view();
+    }
+
+    const dirty_path* tracked_path() const final { return tracked_.path(); }
+
+    const dirty_set* dirty_paths() const final
+    {
+        return tracked_.dirty_paths(*parent());
+    }
+};
+
+template <typename Path, typename Parent>
+using member_reader_node = member_node<Path, Parent, reader_node>;
+
+template <typename Path, typename Parent>
+class member_cursor_node : public member_node<Path, Parent, cursor_node>
+{
+    using base_t = member_node<Path, Parent, cursor_node>;
+
+public:
+    using value_type = typename base_t::value_type;
+
+    using base_t::base_t;
+
+    void send_up(const value_type& value) final
+    {
+        this->refresh_parents();
+        this->push_up(this->path_.set(this->parent()->current(), value));
+    }
+
+    void send_up(value_type&& value) final
+    {
+        this->refresh_parents();
+        auto restore = this->restoring_parents();
+        this->push_up(
+            this->path_.set(this->parent()->take_current(), std::move(value)));
+    }
+};
+
+template <typename Path, typename Parent>
+auto make_member_reader_node(Path&& path,
+                             std::tuple<std::shared_ptr<Parent>> parents)
+{
+    return link_to_parents(
+        std::make_shared<member_reader_node<std::decay_t<Path>, Parent>>(
+            std::forward<Path>(path), std::move(parents)));
+}
+
+template <typename Path, typename Parent>
+auto make_member_cursor_node(Path&& path,
+                             std::tuple<std::shared_ptr<Parent>> parents)
+{
+    return link_to_parents(
+        std::make_shared<member_cursor_node<std::decay_t<Path>, Parent>>(
+            std::forward<Path>(path), std::move(parents)));
+}
+
+} // namespace detail
+
+} // namespace lager
@@ -27,17 +27,4 @@ struct no_value_error : std::exception
     const char* what() const noexcept override { return "no_value_error"; };
 };
 
-namespace detail {
-
-struct no_value
-{
-    template <typename T>
-    operator T() const
-    {
-        throw no_value_error{};
-    }
-};
-
-} // namespace detail
-
 } // namespace lager
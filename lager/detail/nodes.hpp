@@ -38,15 +38,20 @@
 
 #pragma once
 
+#include <lager/detail/diff.hpp>
+#include <lager/detail/dirty.hpp>
 #include <lager/detail/signal.hpp>
 #include <lager/util.hpp>
 
+#include <zug/meta/detected.hpp>
 #include <zug/meta/pack.hpp>
 #include <zug/tuplify.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <memory>
+#include <optional>
 #include <vector>
 
 namespace lager {
@@ -58,7 +63,7 @@ namespace detail {
 constexpr struct
 {
     template <typename T1, typename T2>
-    bool operator()(const T1& a, const T2& b)
+    bool operator()(const T1& a, const T2& b) const
     {
         return !a.owner_before(b) && !b.owner_before(a);
     }
@@ -112,6 +117,10 @@ auto has_changed(const T&, const T&)
     return true;
 }
 
+template <typename T>
+using equality_t =
+    decltype(std::declval<const T&>() == std::declval<const T&>());
+
 struct notifying_guard_t
 {
     notifying_guard_t(bool& target)
@@ -135,27 +144,103 @@ template <typename T>
 class reader_node : public reader_node_base
 {
 public:
-    using value_type  = T;
-    using signal_type = signal<const value_type&>;
+    using value_type       = T;
+    using signal_type      = signal<const value_type&>;
+    using diff_signal_type = signal<const value_diff<value_type>&>;
 
     reader_node(T value)
         : current_(std::move(value))
         , last_(current_)
+        , current_ptr_(&*current_)
+        , last_ptr_(&*last_)
+    {}
+
+    /*!
+     * Constructs a node that does not own its values, but views the ones
+     * at `current` and `last`, which must outlive it.  This is used by nodes
+     * that focus on values stored in their parents.
+     */
+    reader_node(const value_type& current, const value_type& last)
+        : current_ptr_(&current)
+        , last_ptr_(&last)
     {}
 
+    // The pointers may point into the node itself, so copying or moving it
+    // would leave them dangling.
+    reader_node(const reader_node&) = delete;
+    reader_node(reader_node&&)      = delete;
+    reader_node& operator=(const reader_node&) = delete;
+    reader_node& operator=(reader_node&&) = delete;
+
     virtual void recompute() = 0;
     virtual void refresh()   = 0;
 
-    const value_type& current() const { return current_; }
-    const value_type& last() const { return last_; }
+    const value_type& current() const
+    {
+        assert(!current_moved_ && "Current value was moved out of the node");
+        return *current_ptr_;
+    }
+    const value_type& last() const { return *last_ptr_; }
+
+    /*!
+     * Number of times that the last value changed.  It grows monotonically,
+     * so caches of values derived from the node can tell whether they are
+     * still valid in constant time.
+     */
+    std::uint64_t version() const { return version_; }
+
+    /*!
+     * Moves the current value out of the node, so it can be updated and sent
+     * up without copies.  The node is in an invalid state until a new value
+     * is pushed down, see `restore_current()`.  Nodes viewing values owned by
+     * others return a copy instead.
+     */
+    value_type take_current()
+    {
+        if (!current_)
+            return *current_ptr_;
+        current_moved_ = true;
+        return std::move(*current_);
+    }
+
+    /*!
+     * Recomputes the current value if it was taken and no new value has been
+     * pushed down since.  Nodes that push nothing down when recomputed, like
+     * roots or those filtering out the values of their parents, get the last
+     * value back instead.
+     */
+    void restore_current()
+    {
+        if (current_moved_) {
+            refresh();
+            if (current_moved_) {
+                *current_      = *last_;
+                current_moved_ = false;
+            }
+        }
+    }
+
+    bool current_moved() const { return current_moved_; }
+
+    bool needs_send_down() const { return needs_send_down_; }
+
+    /*!
+     * Path from the root that records which of its parts are updated, if
+     * any, to the value of this node.
+     */
+    virtual const dirty_path* tracked_path() const { return nullptr; }
+
+    /*!
+     * Parts of the root value that were updated since it was last sent down,
+     * or null when unknown.
+     */
+    virtual const dirty_set* dirty_paths() const { return nullptr; }
 
     void link(std::weak_ptr<reader_node_base> child)
     {
-        using namespace std;
-        using std::placeholders::_1;
-        assert(find_if(begin(children_),
-                       end(children_),
-                       bind(owner_equals, child, _1)) == end(children_) &&
+        // Children are linked right after construction, so checking against
+        // the last one suffices and keeps linking many children linear.
+        assert((children_.empty() || !owner_equals(children_.back(), child)) &&
                "Child node must not be linked twice");
         children_.push_back(child);
     }
@@ -163,8 +248,29 @@ public:
     template <typename U>
     void push_down(U&& value)
     {
-        if (has_changed(value, current_)) {
-            current_         = std::forward<U>(value);
+        if (current_moved_) {
+            // There is no current value to compare with, but if the new one
+            // matches the last one there is nothing new to send down either.
+            needs_send_down_ = needs_send_down_ || has_changed(value, *last_);
+            *current_        = std::forward<U>(value);
+            current_moved_   = false;
+        } else if (has_changed(value, *current_)) {
+            *current_        = std::forward<U>(value);
+            needs_send_down_ = true;
+        }
+    }
+
+    /*!
+     * Counterpart of `push_down()` for nodes viewing values owned by others,
+     * which are updated in place: flags the node for sending down when the
+     * current value differs from the last one.
+     */
+    void push_down_view()
+    {
+        if constexpr (zug::meta::is_detected<equality_t, value_type>::value) {
+            if (!(current() == last()))
+                needs_send_down_ = true;
+        } else {
             needs_send_down_ = true;
         }
     }
@@ -173,14 +279,23 @@ public:
     {
         recompute();
         if (needs_send_down_) {
-            last_            = current_;
             needs_send_down_ = false;
             needs_notify_    = true;
+            ++version_;
+            // The last value is updated after the children are, so nodes
+            // viewing parts of it can still compare against the old one.
             for (auto& wchild : children_) {
                 if (auto child = wchild.lock()) {
                     child->send_down();
                 }
             }
+            if (current_) {
+                if (!diff_observers_.empty() && !previous_)
+                    previous_ = std::move(*last_);
+                *last_ = *current_;
+            } else if (!diff_observers_.empty() && !previous_) {
+                previous_ = last();
+            }
         }
     }
 
@@ -193,7 +308,12 @@ public:
             notifying_guard_t notifying_guard(notifying_);
             bool garbage = false;
 
-            observers_(last_);
+            observers_(last());
+            if (previous_) {
+                auto previous = std::move(*previous_);
+                previous_.reset();
+                diff_observers_(value_diff<value_type>{previous, last()});
+            }
             for (size_t i = 0, size = children_.size(); i < size; ++i) {
                 if (auto child = children_[i].lock()) {
                     child->notify();
@@ -209,6 +329,7 @@ public:
     }
 
     auto observers() -> signal_type& { return observers_; }
+    auto diff_observers() -> diff_signal_type& { return diff_observers_; }
 
 private:
     void collect()
@@ -220,14 +341,23 @@ private:
                         end(children_));
     }
 
-    value_type current_;
-    value_type last_;
+    // Only engaged for nodes owning their values, the pointers are to be
+    // used for reading them.
+    std::optional<value_type> current_;
+    std::optional<value_type> last_;
+    const value_type* current_ptr_;
+    const value_type* last_ptr_;
     std::vector<std::weak_ptr<reader_node_base>> children_;
     signal_type observers_;
+    diff_signal_type diff_observers_;
+    // Value notified last time, only kept while there are diff observers.
+    std::optional<value_type> previous_;
+    std::uint64_t version_ = 0;
 
     bool needs_send_down_ = false;
     bool needs_notify_    = false;
     bool notifying_       = false;
+    bool current_moved_   = false;
 };
 
 /*!
@@ -260,11 +390,44 @@ public:
         , parents_{std::move(parents)}
     {}
 
+    inner_node(const ValueT& current,
+               const ValueT& last,
+               std::tuple<std::shared_ptr<Parents>...>&& parents)
+        : base_t{current, last}
+        , parents_{std::move(parents)}
+    {}
+
     void refresh() final
+    {
+        refresh_parents();
+        this->recompute();
+    }
+
+    void refresh_parents()
     {
         std::apply([&](auto&&... ps) { noop((ps->refresh(), 0)...); },
                    parents_);
-        this->recompute();
+    }
+
+    void restore_parents()
+    {
+        std::apply([&](auto&&... ps) { noop((ps->restore_current(), 0)...); },
+                   parents_);
+    }
+
+    /*!
+     * Returns a guard that calls `restore_parents()` when it goes out of
+     * scope, so the parents get their values back also when sending them up
+     * throws.
+     */
+    auto restoring_parents()
+    {
+        struct guard
+        {
+            inner_node& self;
+            ~guard() { self.restore_parents(); }
+        };
+        return guard{*this};
     }
 
     const std::tuple<std::shared_ptr<Parents>...>& parents() const
@@ -314,6 +477,14 @@ current_from(const std::tuple<std::shared_ptr<Nodes>...>& parents)
         parents);
 }
 
+template <typename... Nodes>
+auto take_current_from(const std::tuple<std::shared_ptr<Nodes>...>& parents)
+{
+    return std::apply(
+        [&](auto&&... ptrs) { return zug::tuplify(ptrs->take_current()...); },
+        parents);
+}
+
 template <typename Node>
 std::shared_ptr<Node> link_to_parents(std::shared_ptr<Node> n)
 {
@@ -14,6 +14,7 @@
 
 #include <boost/intrusive/list.hpp>
 
+#include <algorithm>
 #include <memory>
 
 namespace lager {
@@ -35,6 +36,9 @@ public:
     {
         virtual ~slot_base()             = default;
         virtual void operator()(Args...) = 0;
+
+        //! Slots with higher priority are invoked first.
+        int priority = 0;
     };
 
     template <typename Fn>
@@ -60,15 +64,31 @@ public:
     };
 
     template <typename Fn>
-    connection connect(Fn&& fn)
+    connection connect(Fn&& fn, int priority = 0)
     {
         using slot_t = slot<std::decay_t<Fn>>;
         auto s       = std::make_unique<slot_t>(std::forward<Fn>(fn));
-        slots_.push_back(*s);
+        s->priority  = priority;
+        add(*s);
         return {std::move(s)};
     }
 
-    void add(slot_base& slot) { slots_.push_back(slot); }
+    /*!
+     * Adds the slot after all the slots of the same or higher priority, such
+     * that slots of equal priority are invoked in connection order.
+     */
+    void add(slot_base& slot)
+    {
+        if (slots_.empty() || slots_.back().priority >= slot.priority) {
+            slots_.push_back(slot);
+        } else {
+            auto it = std::find_if(
+                slots_.begin(), slots_.end(), [&](const slot_base& s) {
+                    return s.priority < slot.priority;
+                });
+            slots_.insert(it, slot);
+        }
+    }
 
     template <typename... Args2>
     void operator()(Args2&&... args)
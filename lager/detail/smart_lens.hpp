@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <lager/detail/dirty.hpp>
 #include <lager/lenses.hpp>
 #include <lager/lenses/at.hpp>
 #include <lager/lenses/attr.hpp>
@@ -38,13 +39,16 @@ struct smart_lens_base
     template <typename Key, std::enable_if_t<zug::meta::is_detected<at_t, T, Key>::value, int> = 0>
     static auto make(Key k)
     {
-        return lenses::at(std::move(k));
+        if constexpr (is_path_key_v<Key>)
+            return make_keyed_lens(lenses::at(k), k);
+        else
+            return lenses::at(std::move(k));
     }
 
     template <typename U, typename V>
     static auto make(U V::*member)
     {
-        return lenses::attr(member);
+        return make_keyed_lens(lenses::attr(member), member);
     }
 };
 
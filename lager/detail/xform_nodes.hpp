@@ -22,7 +22,7 @@
 #include <zug/tuplify.hpp>
 #include <zug/util.hpp>
 
-#include <zug/reducing/last.hpp>
+#include <optional>
 
 namespace lager {
 namespace detail {
@@ -43,21 +43,35 @@ ZUG_INLINE_CONSTEXPR struct send_down_rf_t
     }
 } send_down_rf{};
 
-template <typename ValueT, typename Xform, typename... ParentPtrs>
-ValueT initial_value(Xform&& xform, const std::tuple<ParentPtrs...>& parents)
+/*!
+ * Accumulator for `send_down_rf` that stores the last value produced by a
+ * transducer, if any.  This allows detecting that a transducer filtered out
+ * the initial value of a node without raising exceptions.
+ */
+template <typename T>
+struct initial_value_sink
+{
+    std::optional<T> value;
+
+    template <typename U>
+    void push_down(U&& v)
+    {
+        value.emplace(std::forward<U>(v));
+    }
+};
+
+template <typename ValueT, typename Step, typename... ParentPtrs>
+ValueT initial_value(Step& step, const std::tuple<ParentPtrs...>& parents)
 {
-    try {
-        return std::apply(
-            [&](auto&&... ps) {
-                return xform(zug::last)(detail::no_value{}, ps->current()...);
-            },
-            parents);
-    } catch (const no_value_error&) {
-        if constexpr (std::is_default_constructible<ValueT>::value) {
-            return ValueT{};
-        } else {
-            throw;
-        }
+    auto sink = initial_value_sink<ValueT>{};
+    std::apply([&](auto&&... ps) { step(&sink, ps->current()...); },
+               parents);
+    if (sink.value) {
+        return std::move(*sink.value);
+    } else if constexpr (std::is_default_constructible<ValueT>::value) {
+        return ValueT{};
+    } else {
+        throw no_value_error{};
     }
 };
 
@@ -83,15 +97,22 @@ class xform_reader_node<Xform, zug::meta::pack<Parents...>, Base>
 
     down_rf_t down_step_;
 
+    // The same reducing function computes the initial value and the later
+    // ones, so stateful transducers see every input.
+    template <typename ParentsTuple>
+    xform_reader_node(down_rf_t step, ParentsTuple&& parents)
+        : base_t{initial_value<typename base_t::value_type>(step, parents),
+                 std::forward<ParentsTuple>(parents)}
+        , down_step_{std::move(step)}
+    {}
+
 public:
     using value_type = typename base_t::value_type;
 
     template <typename Xform2, typename ParentsTuple>
     xform_reader_node(Xform2&& xform, ParentsTuple&& parents)
-        : base_t{initial_value<value_type>(std::forward<Xform2>(xform),
-                                           parents),
-                 std::forward<ParentsTuple>(parents)}
-        , down_step_{std::forward<Xform2>(xform)(send_down_rf)}
+        : xform_reader_node{std::forward<Xform2>(xform)(send_down_rf),
+                            std::forward<ParentsTuple>(parents)}
     {}
 
     void recompute() final
@@ -0,0 +1,94 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/diff.hpp>
+
+#include <immer/algorithm.hpp>
+#include <immer/map.hpp>
+#include <immer/set.hpp>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace lager {
+
+//! @defgroup cursors
+//! @{
+
+/*!
+ * Change set between two versions of an associative container.  It points to
+ * the elements of the compared containers, so it is only valid as long as
+ * these are alive---for diff watchers, during the invocation of the callback.
+ */
+template <typename T>
+struct change_set
+{
+    using value_type = T;
+
+    std::vector<const T*> added;
+    std::vector<const T*> removed;
+    std::vector<std::pair<const T*, const T*>> changed;
+
+    bool empty() const
+    {
+        return added.empty() && removed.empty() && changed.empty();
+    }
+};
+
+namespace detail {
+
+template <typename Container>
+struct immer_changes_traits
+{
+    using type = change_set<typename Container::value_type>;
+
+    static type make(const Container& old_value, const Container& new_value)
+    {
+        auto result = type{};
+        immer::diff(
+            old_value,
+            new_value,
+            [&](auto&& x) { result.added.push_back(&x); },
+            [&](auto&& x) { result.removed.push_back(&x); },
+            [&](auto&& x, auto&& y) { result.changed.push_back({&x, &y}); });
+        return result;
+    }
+};
+
+} // namespace detail
+
+template <typename K,
+          typename T,
+          typename Hash,
+          typename Equal,
+          typename MemoryPolicy,
+          std::uint32_t B>
+struct changes_traits<immer::map<K, T, Hash, Equal, MemoryPolicy, B>>
+    : detail::immer_changes_traits<
+          immer::map<K, T, Hash, Equal, MemoryPolicy, B>>
+{};
+
+template <typename T,
+          typename Hash,
+          typename Equal,
+          typename MemoryPolicy,
+          std::uint32_t B>
+struct changes_traits<immer::set<T, Hash, Equal, MemoryPolicy, B>>
+    : detail::immer_changes_traits<immer::set<T, Hash, Equal, MemoryPolicy, B>>
+{};
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,471 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lager {
+
+namespace detail {
+
+/*!
+ * Unbounded multiple-producer single-consumer queue.  Pushing is wait-free
+ * and popping is lock-free, after the intrusive queue by Dmitry Vyukov.
+ * `pop()` may spuriously return nothing while a `push()` is in progress in
+ * another thread.
+ */
+template <typename T>
+class mpsc_queue
+{
+    struct node
+    {
+        std::atomic<node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+    std::atomic<node*> head_;
+    node* tail_;
+    node stub_;
+
+    void push_node(node* n)
+    {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        auto prev = head_.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    std::optional<T> take(node* n)
+    {
+        auto value = std::move(n->value);
+        delete n;
+        return value;
+    }
+
+public:
+    mpsc_queue()
+        : head_{&stub_}
+        , tail_{&stub_}
+    {}
+
+    mpsc_queue(const mpsc_queue&) = delete;
+    mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+    ~mpsc_queue()
+    {
+        while (pop())
+            ;
+    }
+
+    void push(T value)
+    {
+        auto n = new node{};
+        n->value.emplace(std::move(value));
+        push_node(n);
+    }
+
+    std::optional<T> pop()
+    {
+        auto tail = tail_;
+        auto next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_) {
+            if (!next)
+                return std::nullopt;
+            tail_ = next;
+            tail  = next;
+            next  = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail_ = next;
+            return take(tail);
+        }
+        if (tail != head_.load(std::memory_order_acquire))
+            return std::nullopt;
+        push_node(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            tail_ = next;
+            return take(tail);
+        }
+        return std::nullopt;
+    }
+};
+
+} // namespace detail
+
+/*!
+ * Counters of the events processed by an actor of an `actor_scheduler`.
+ */
+struct actor_metrics
+{
+    //! Events posted to the actor.
+    std::uint64_t posted = 0;
+    //! Events that the actor processed.
+    std::uint64_t processed = 0;
+    //! Times that the actor was scheduled to process its events.
+    std::uint64_t turns = 0;
+
+    //! Events waiting in the mailbox of the actor.
+    std::uint64_t queued() const { return posted - processed; }
+};
+
+/*!
+ * Runs many independent actors, like stores with a `with_actor_event_loop`,
+ * on a fixed pool of threads.  Every actor has its own lock-free mailbox and
+ * processes its events serially, but different actors run in parallel.
+ *
+ * Each thread has a queue of the actors that have events to process, and
+ * threads that run out of work steal actors from the others.  For fairness,
+ * an actor processes at most `budget` events per turn, and then goes to the
+ * back of the queue if it has more.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto scheduler = lager::actor_scheduler{};
+ *    auto stores    = std::vector<document_store>{};
+ *    for (auto& doc : docs)
+ *        stores.push_back(lager::make_store<action>(
+ *            doc, update, lager::with_actor_event_loop{scheduler}));
+ *
+ * @endrst
+ *
+ * Threads only take a lock to go to sleep when they run out of work, or to
+ * wake others up.  The counts of queued and running tasks are atomic.
+ *
+ * @note The scheduler must outlive the stores using it.  Its destructor
+ *       waits until all the posted events were processed.
+ *
+ * @note Exceptions thrown by a task do not stop the scheduler.  The first one
+ *       is rethrown by the next call to `wait_idle()`, and the others are
+ *       dropped.
+ */
+class actor_scheduler
+{
+public:
+    using task_fn = std::function<void()>;
+
+    actor_scheduler(std::size_t threads = std::thread::hardware_concurrency(),
+                    std::size_t budget  = 64)
+        : budget_{budget ? budget : 1}
+        , workers_(threads ? threads : 1)
+    {
+        for (auto i = std::size_t{}; i < workers_.size(); ++i)
+            workers_[i].thread = std::thread{[this, i] { run(i); }};
+    }
+
+    actor_scheduler(const actor_scheduler&) = delete;
+    actor_scheduler& operator=(const actor_scheduler&) = delete;
+
+    ~actor_scheduler()
+    {
+        {
+            auto lock = std::unique_lock<std::mutex>{sleep_mutex_};
+            done_     = true;
+        }
+        sleep_cv_.notify_all();
+        for (auto& w : workers_)
+            w.thread.join();
+    }
+
+    std::size_t budget() const { return budget_; }
+
+    /*!
+     * Runs `fn` in some thread of the pool.
+     */
+    void spawn(task_fn fn)
+    {
+        auto index = current_worker();
+        if (index >= workers_.size())
+            index = next_worker_++ % workers_.size();
+        // Count the task before queuing it, so `pending_` never underflows
+        // when a worker takes it right away.
+        pending_.fetch_add(1);
+        {
+            auto& w   = workers_[index];
+            auto lock = std::unique_lock<std::mutex>{w.mutex};
+            w.tasks.push_back(std::move(fn));
+        }
+        if (sleeping_.load() > 0) {
+            // A worker that is about to sleep has already checked
+            // `pending_` while holding the lock, or will see the new count.
+            auto lock = std::unique_lock<std::mutex>{sleep_mutex_};
+            lock.unlock();
+            sleep_cv_.notify_one();
+        }
+    }
+
+    /*!
+     * Blocks until there are no events left to process.  Rethrows the first
+     * exception thrown by a task since the last call, if any.
+     */
+    void wait_idle()
+    {
+        auto lock = std::unique_lock<std::mutex>{sleep_mutex_};
+        idle_cv_.wait(lock, [&] { return pending_ == 0 && running_ == 0; });
+        if (error_)
+            std::rethrow_exception(std::exchange(error_, nullptr));
+    }
+
+private:
+    struct worker
+    {
+        std::mutex mutex;
+        std::deque<task_fn> tasks;
+        std::thread thread;
+    };
+
+    std::size_t current_worker() const
+    {
+        return current_scheduler() == this ? current_index()
+                                           : workers_.size();
+    }
+
+    static const actor_scheduler*& current_scheduler()
+    {
+        thread_local const actor_scheduler* scheduler = nullptr;
+        return scheduler;
+    }
+
+    static std::size_t& current_index()
+    {
+        thread_local std::size_t index = 0;
+        return index;
+    }
+
+    std::optional<task_fn> pop(std::size_t index)
+    {
+        {
+            auto& w   = workers_[index];
+            auto lock = std::unique_lock<std::mutex>{w.mutex};
+            if (!w.tasks.empty()) {
+                auto fn = std::move(w.tasks.front());
+                w.tasks.pop_front();
+                return fn;
+            }
+        }
+        for (auto i = std::size_t{1}; i < workers_.size(); ++i) {
+            auto& w   = workers_[(index + i) % workers_.size()];
+            auto lock = std::unique_lock<std::mutex>{w.mutex};
+            if (!w.tasks.empty()) {
+                auto fn = std::move(w.tasks.back());
+                w.tasks.pop_back();
+                return fn;
+            }
+        }
+        return std::nullopt;
+    }
+
+    void execute(task_fn& fn)
+    {
+        try {
+            fn();
+        } catch (...) {
+            auto lock = std::unique_lock<std::mutex>{sleep_mutex_};
+            if (!error_)
+                error_ = std::current_exception();
+        }
+        if (running_.fetch_sub(1) == 1 && pending_.load() == 0) {
+            auto lock = std::unique_lock<std::mutex>{sleep_mutex_};
+            lock.unlock();
+            idle_cv_.notify_all();
+        }
+    }
+
+    void run(std::size_t index)
+    {
+        current_scheduler() = this;
+        current_index()     = index;
+        while (true) {
+            if (auto fn = pop(index)) {
+                // Count it as running before it stops being pending, so the
+                // scheduler never looks idle in between.
+                running_.fetch_add(1);
+                pending_.fetch_sub(1);
+                execute(*fn);
+                continue;
+            }
+            if (pending_.load() > 0) {
+                // The task is being queued, or another worker took it and
+                // has not counted it yet.
+                std::this_thread::yield();
+                continue;
+            }
+            auto lock = std::unique_lock<std::mutex>{sleep_mutex_};
+            sleeping_.fetch_add(1);
+            sleep_cv_.wait(lock, [&] { return done_ || pending_ > 0; });
+            sleeping_.fetch_sub(1);
+            if (done_ && pending_ == 0)
+                return;
+        }
+    }
+
+    std::size_t budget_;
+    std::vector<worker> workers_;
+    std::atomic<std::size_t> next_worker_{0};
+    std::atomic<std::size_t> pending_{0};
+    std::atomic<std::size_t> running_{0};
+    std::atomic<std::size_t> sleeping_{0};
+
+    std::mutex sleep_mutex_;
+    std::condition_variable sleep_cv_;
+    std::condition_variable idle_cv_;
+    std::exception_ptr error_;
+    bool done_ = false;
+};
+
+namespace detail {
+
+class actor : public std::enable_shared_from_this<actor>
+{
+public:
+    using event_fn = std::function<void()>;
+
+    actor(actor_scheduler& scheduler)
+        : scheduler_{scheduler}
+    {}
+
+    void post(event_fn ev)
+    {
+        if (finished_.load(std::memory_order_acquire))
+            return;
+        posted_.fetch_add(1, std::memory_order_relaxed);
+        mailbox_.push(std::move(ev));
+        schedule();
+    }
+
+    void finish() { finished_.store(true, std::memory_order_release); }
+
+    void pause() { paused_.store(true, std::memory_order_release); }
+
+    void resume()
+    {
+        paused_.store(false, std::memory_order_release);
+        schedule();
+    }
+
+    actor_metrics metrics() const
+    {
+        auto processed = processed_.load(std::memory_order_acquire);
+        return {posted_.load(std::memory_order_acquire),
+                processed,
+                turns_.load(std::memory_order_acquire)};
+    }
+
+    actor_scheduler& scheduler() const { return scheduler_; }
+
+private:
+    bool has_work() const
+    {
+        return !paused_.load(std::memory_order_acquire) &&
+               processed_.load(std::memory_order_relaxed) <
+                   posted_.load(std::memory_order_acquire);
+    }
+
+    void schedule()
+    {
+        if (has_work() && !scheduled_.exchange(true, std::memory_order_acq_rel))
+            scheduler_.spawn([self = shared_from_this()] { self->turn(); });
+    }
+
+    void turn()
+    {
+        turns_.fetch_add(1, std::memory_order_relaxed);
+        for (auto n = scheduler_.budget(); n > 0 && has_work(); --n) {
+            auto ev = mailbox_.pop();
+            if (!ev) {
+                // A `post()` is halfway through pushing.  It already counted
+                // the event so we will be scheduled again right below.
+                break;
+            }
+            try {
+                (*ev)();
+            } catch (...) {
+                // Keep processing the mailbox in a later turn, and let the
+                // scheduler report the error.
+                processed_.fetch_add(1, std::memory_order_release);
+                scheduled_.store(false, std::memory_order_release);
+                schedule();
+                throw;
+            }
+            processed_.fetch_add(1, std::memory_order_release);
+        }
+        scheduled_.store(false, std::memory_order_release);
+        schedule();
+    }
+
+    actor_scheduler& scheduler_;
+    mpsc_queue<event_fn> mailbox_;
+    std::atomic<bool> scheduled_{false};
+    std::atomic<bool> paused_{false};
+    std::atomic<bool> finished_{false};
+    std::atomic<std::uint64_t> posted_{0};
+    std::atomic<std::uint64_t> processed_{0};
+    std::atomic<std::uint64_t> turns_{0};
+};
+
+} // namespace detail
+
+/*!
+ * Event loop for stores that processes their actions in an `actor_scheduler`.
+ * Every store gets its own mailbox, and the actions of a store are never
+ * processed concurrently, so the store can be used as with a single threaded
+ * event loop from the watchers and effects.  `dispatch()` can be called from
+ * any thread.
+ */
+struct with_actor_event_loop
+{
+    with_actor_event_loop(actor_scheduler& scheduler)
+        : actor_{std::make_shared<detail::actor>(scheduler)}
+    {}
+
+    template <typename Fn>
+    void async(Fn&& fn)
+    {
+        actor_->scheduler().spawn(std::forward<Fn>(fn));
+    }
+
+    template <typename Fn>
+    void post(Fn&& fn)
+    {
+        actor_->post(std::forward<Fn>(fn));
+    }
+
+    void finish() { actor_->finish(); }
+    void pause() { actor_->pause(); }
+    void resume() { actor_->resume(); }
+
+    /*!
+     * Returns the current counters of the mailbox of the store.  They are
+     * updated concurrently, so `queued()` is only an estimate while the
+     * store is processing actions.
+     */
+    actor_metrics metrics() const { return actor_->metrics(); }
+
+private:
+    std::shared_ptr<detail::actor> actor_;
+};
+
+} // namespace lager
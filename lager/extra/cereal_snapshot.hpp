@@ -0,0 +1,123 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <cereal/archives/json.hpp>
+#include <cereal/cereal.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace lager {
+
+namespace detail {
+
+inline void write_snapshot_file(const std::string& path,
+                                const std::string& data)
+{
+    auto file = std::fopen(path.c_str(), "wb");
+    if (!file)
+        throw std::runtime_error{"could not write snapshot: " + path};
+    auto ok = std::fwrite(data.data(), 1, data.size(), file) == data.size() &&
+              std::fflush(file) == 0;
+#if defined(_WIN32)
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && ::fsync(fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+    if (!ok) {
+        auto ec = std::error_code{};
+        std::filesystem::remove(path, ec);
+        throw std::runtime_error{"could not write snapshot: " + path};
+    }
+}
+
+// Makes the renaming of a snapshot durable.  Windows has no way to sync a
+// directory, there the rename is as durable as the file system makes it.
+inline void sync_snapshot_dir(const std::string& path)
+{
+#if !defined(_WIN32)
+    auto dir = std::filesystem::path{path}.parent_path();
+    auto fd  = ::open(dir.empty() ? "." : dir.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error{"could not sync snapshot: " + path};
+    auto ok = ::fsync(fd) == 0;
+    ::close(fd);
+    if (!ok)
+        throw std::runtime_error{"could not sync snapshot: " + path};
+#endif
+}
+
+} // namespace detail
+
+//! @defgroup snapshot
+//! @{
+
+/*!
+ * Returns a saver for a `snapshotter` that serializes the model with Cereal
+ * to the file at `path`.  The snapshot is first written and synced to a
+ * temporary file that then replaces the previous one, so a crash while saving
+ * never leaves a truncated snapshot behind.  Errors are thrown before the
+ * previous snapshot is replaced.
+ */
+template <typename Model, typename Archive = cereal::JSONOutputArchive>
+auto cereal_snapshot_saver(std::string path)
+{
+    return [path = std::move(path)](const Model& m) {
+        auto os = std::ostringstream{};
+        {
+            // Some archives only finish writing when destroyed.
+            auto ar = Archive{os};
+            ar(cereal::make_nvp("model", m));
+        }
+        if (!os)
+            throw std::runtime_error{"could not serialize snapshot: " + path};
+        auto tmp = path + ".tmp";
+        detail::write_snapshot_file(tmp, os.str());
+        std::filesystem::rename(tmp, path);
+        detail::sync_snapshot_dir(path);
+    };
+}
+
+/*!
+ * Reads a model saved by a `cereal_snapshot_saver()`.
+ */
+template <typename Model, typename Archive = cereal::JSONInputArchive>
+Model load_cereal_snapshot(const std::string& path)
+{
+    auto is = std::ifstream{path, std::ios::binary};
+    if (!is)
+        throw std::runtime_error{"could not read snapshot: " + path};
+    auto ar = Archive{is};
+    auto m  = Model{};
+    ar(cereal::make_nvp("model", m));
+    return m;
+}
+
+//! @}
+
+} // namespace lager
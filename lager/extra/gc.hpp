@@ -0,0 +1,32 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <immer/heap/gc_heap.hpp>
+#include <immer/heap/heap_policy.hpp>
+#include <immer/memory_policy.hpp>
+#include <immer/refcount/no_refcount_policy.hpp>
+
+namespace lager {
+
+/*!
+ * Memory policy for immer containers that are garbage collected with the
+ * Boehm conservative collector instead of reference counted.  Copying and
+ * releasing values is free, which pays off when long histories are kept,
+ * like in the `debugger`.  Using this header requires linking to `libgc`.
+ */
+using gc_memory_policy =
+    immer::memory_policy<immer::heap_policy<immer::gc_heap>,
+                         immer::no_refcount_policy>;
+
+} // namespace lager
@@ -0,0 +1,102 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+namespace lager {
+
+/*!
+ * Keeps values derived from the model, like per-item contexts or cursors,
+ * across the frames of an immediate-mode UI such as Dear ImGui.  Instead of
+ * rebuilding them every frame, `get()` returns the value cached for a key and
+ * only makes it the first time the key is seen.  Call `collect()` once per
+ * frame, after drawing, to evict the entries that were not used during it.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto item_contexts =
+ *        lager::frame_cache<std::size_t, lager::context<item_action>>{};
+ *    ...
+ *    for (auto idx = std::size_t{}; idx < m.todos.size(); ++idx) {
+ *        auto& item_ctx = item_contexts.get(idx, [&] {
+ *            return lager::context<item_action>{ctx, [idx](auto&& a) {
+ *                return std::make_pair(idx, LAGER_FWD(a));
+ *            }};
+ *        });
+ *        draw(item_ctx, m.todos[idx]);
+ *    }
+ *    item_contexts.collect();
+ *
+ * @endrst
+ *
+ * @note Values are cached by key only, so the key must identify all the
+ *       state that the value is derived from.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class frame_cache
+{
+public:
+    using key_type   = Key;
+    using value_type = Value;
+
+    /*!
+     * Returns the value for `key`, calling `make()` to create it if it is not
+     * in the cache, and marks it as used in the current frame.
+     */
+    template <typename Fn>
+    Value& get(const Key& key, Fn&& make)
+    {
+        auto it = entries_.find(key);
+        if (it == entries_.end())
+            it = entries_.emplace(key, entry{std::forward<Fn>(make)()}).first;
+        it->second.used = true;
+        return it->second.value;
+    }
+
+    /*!
+     * Evicts the values that were not used since the last call and starts a
+     * new frame.
+     */
+    void collect()
+    {
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (it->second.used) {
+                it->second.used = false;
+                ++it;
+            } else {
+                it = entries_.erase(it);
+            }
+        }
+    }
+
+    void clear() { entries_.clear(); }
+
+    std::size_t size() const { return entries_.size(); }
+
+private:
+    struct entry
+    {
+        Value value;
+        bool used = false;
+    };
+
+    std::unordered_map<Key, entry, Hash> entries_;
+};
+
+} // namespace lager
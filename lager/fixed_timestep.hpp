@@ -0,0 +1,95 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace lager {
+
+/*!
+ * Accumulates the time elapsed between rendered frames and tells how many
+ * simulation steps of a fixed duration should be applied to catch up.  Use it
+ * together with `batch_action` and `with_batches()` to run a fixed timestep
+ * simulation that notifies the views only once per frame:
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto timestep = lager::fixed_timestep<>{ms{10}};
+ *    loop.run(handle_event, [&](float delta) {
+ *        if (auto n = timestep.advance(ms{delta}))
+ *            store.dispatch(lager::batch_action<action>{
+ *                n, tick_action{timestep.step().count()}});
+ *        return true;
+ *    });
+ *
+ * @endrst
+ *
+ * When more than `max_steps` steps would be needed, only `max_steps` are
+ * applied and the remaining time is dropped, so that a slow frame does not
+ * make the simulation fall further and further behind.
+ */
+template <typename Duration = std::chrono::duration<float, std::milli>>
+class fixed_timestep
+{
+public:
+    using duration = Duration;
+
+    fixed_timestep(duration step, std::size_t max_steps = 8)
+        : step_{step}
+        , max_steps_{max_steps}
+    {}
+
+    /*!
+     * Adds `elapsed` to the accumulated time and returns the number of steps
+     * that should be simulated now.
+     */
+    std::size_t advance(duration elapsed)
+    {
+        using rep = typename duration::rep;
+        lag_ += elapsed;
+        auto n = static_cast<std::size_t>(lag_ / step_);
+        if (n > max_steps_) {
+            n    = max_steps_;
+            lag_ = duration{};
+        } else {
+            lag_ -= step_ * static_cast<rep>(n);
+        }
+        return n;
+    }
+
+    /*!
+     * Duration of a simulation step.
+     */
+    duration step() const { return step_; }
+
+    /*!
+     * Accumulated time not yet simulated, as a fraction of a step.  This can
+     * be used to interpolate between the last two states when rendering.
+     */
+    float alpha() const
+    {
+        using fsecs = std::chrono::duration<float>;
+        return std::chrono::duration_cast<fsecs>(lag_).count() /
+               std::chrono::duration_cast<fsecs>(step_).count();
+    }
+
+private:
+    duration step_;
+    duration lag_ = {};
+    std::size_t max_steps_;
+};
+
+} // namespace lager
@@ -0,0 +1,268 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/context.hpp>
+#include <lager/detail/dirty.hpp>
+#include <lager/lenses.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace lager {
+
+//! @defgroup fork_join
+//! @{
+
+/*!
+ * Part of the model, focused by `lens`, that `reducer` updates independently
+ * of the rest.  The reducer takes the part and the action, and returns the new
+ * part, or a pair of the new part and an effect.  @see `fork_join()`
+ */
+template <typename Lens, typename Reducer>
+struct slice_t
+{
+    Lens lens;
+    Reducer reducer;
+};
+
+template <typename Lens, typename Reducer>
+auto slice(Lens&& lens, Reducer&& reducer)
+    -> slice_t<std::decay_t<Lens>, std::decay_t<Reducer>>
+{
+    return {std::forward<Lens>(lens), std::forward<Reducer>(reducer)};
+}
+
+//! @}
+
+namespace detail {
+
+/*!
+ * Counts the tasks forked by a `fork_join()` reducer that are still running,
+ * and waits for them when destroyed.
+ */
+class join_latch
+{
+public:
+    join_latch() = default;
+    join_latch(const join_latch&) = delete;
+    join_latch& operator=(const join_latch&) = delete;
+
+    ~join_latch()
+    {
+        auto lock = std::unique_lock<std::mutex>{mutex_};
+        cv_.wait(lock, [&] { return pending_ == 0; });
+    }
+
+    void add()
+    {
+        auto lock = std::lock_guard<std::mutex>{mutex_};
+        ++pending_;
+    }
+
+    void done()
+    {
+        // Notifying with the lock held, so the latch is not destroyed by the
+        // waiting thread while still in use here.
+        auto lock = std::lock_guard<std::mutex>{mutex_};
+        --pending_;
+        cv_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::size_t pending_ = 0;
+};
+
+template <typename Part, typename Result>
+constexpr bool slice_has_effect_v =
+    !std::is_same_v<Part, std::decay_t<Result>>;
+
+template <typename Part, typename Result>
+decltype(auto) slice_part(Result&& r)
+{
+    if constexpr (slice_has_effect_v<Part, Result>)
+        return std::get<0>(std::forward<Result>(r));
+    else
+        return std::forward<Result>(r);
+}
+
+template <typename Part, typename Result>
+auto slice_effect(Result&& r)
+{
+    if constexpr (slice_has_effect_v<Part, Result>)
+        return std::make_tuple(std::get<1>(std::forward<Result>(r)));
+    else
+        return std::tuple<>{};
+}
+
+template <typename Slice, typename Model>
+using slice_part_t =
+    std::decay_t<decltype(view(std::declval<const Slice&>().lens,
+                               std::declval<const Model&>()))>;
+
+template <typename Executor, typename... Slices>
+struct fork_join_reducer
+{
+    Executor executor;
+    std::tuple<Slices...> slices;
+
+    template <typename Model, typename Action>
+    auto operator()(Model model, const Action& action) const
+    {
+        return reduce(
+            std::move(model), action, std::index_sequence_for<Slices...>{});
+    }
+
+private:
+    template <typename Model, typename Action, std::size_t... Is>
+    auto reduce(Model model,
+                const Action& action,
+                std::index_sequence<Is...>) const
+    {
+        // The parts are viewed and set back in the calling thread, only the
+        // reducers of the slices run concurrently.
+        auto tasks =
+            std::make_tuple(make_task(std::get<Is>(slices), model, action)...);
+        auto futures = std::make_tuple(std::get<Is>(tasks)->get_future()...);
+        {
+            // The tasks refer to the action and the slices, so they are
+            // waited for before leaving, even when forking fails.
+            auto latch = join_latch{};
+            (fork<Is>(std::get<Is>(tasks), latch), ...);
+            (*std::get<0>(tasks))();
+        }
+        // Braced initialization gets the results in order, so the error of
+        // the first failing slice is the one rethrown.
+        auto results = std::tuple<decltype(std::get<Is>(futures).get())...>{
+            std::get<Is>(futures).get()...};
+        ((model = set(std::get<Is>(slices).lens,
+                      std::move(model),
+                      slice_part<slice_part_t<Slices, Model>>(
+                          std::get<Is>(std::move(results))))),
+         ...);
+        // The updates done by the slices in other threads are not recorded
+        // when wrapped in a `tracked_reducer()`, so any part may have changed.
+        if (auto tracker = dirty_tracker::current())
+            tracker->mark_all();
+        auto effects =
+            std::tuple_cat(slice_effect<slice_part_t<Slices, Model>>(
+                std::get<Is>(std::move(results)))...);
+        if constexpr (std::tuple_size_v<decltype(effects)> == 0) {
+            return model;
+        } else {
+            // The effects run in the order of the slices, no matter in which
+            // order their reducers finished.
+            return std::make_pair(
+                std::move(model),
+                [effects = std::move(effects)](auto&& ctx) -> void {
+                    auto run = [&](auto& e) {
+                        if (!is_empty_effect(e))
+                            e(ctx);
+                    };
+                    std::apply([&](auto&... es) { (run(es), ...); }, effects);
+                });
+        }
+    }
+
+    template <typename Slice, typename Model, typename Action>
+    static auto
+    make_task(const Slice& slice, const Model& model, const Action& action)
+    {
+        using part_t   = slice_part_t<Slice, Model>;
+        using result_t = std::invoke_result_t<decltype(slice.reducer)&,
+                                              part_t,
+                                              const Action&>;
+        auto part      = part_t(view(slice.lens, model));
+        return std::make_shared<std::packaged_task<result_t()>>(
+            [&slice, &action, part = std::move(part)]() mutable {
+                return std::invoke(slice.reducer, std::move(part), action);
+            });
+    }
+
+    template <std::size_t I, typename Task>
+    void fork(const Task& task, join_latch& latch) const
+    {
+        if constexpr (I > 0) {
+            latch.add();
+            try {
+                executor([task, &latch] {
+                    (*task)();
+                    latch.done();
+                });
+            } catch (...) {
+                latch.done();
+                throw;
+            }
+        }
+    }
+};
+
+} // namespace detail
+
+//! @addtogroup fork_join
+//! @{
+
+/*!
+ * Returns a reducer that updates independent slices of the model in parallel.
+ * For every action, the reducers of all the `slices` but the first one are
+ * passed to the `executor`, which is called with a copyable function object
+ * taking no arguments and should run it, usually in a thread pool, while the
+ * first one runs in the calling thread.  Once all are done, the updated parts
+ * are set back into the model in order.  If some reducers return effects, the
+ * reducer returns an effect that evaluates them in the order of the slices.
+ *
+ * @note The slices must not overlap, and their reducers must be safe to call
+ *       concurrently.
+ *
+ * @note The reducer blocks until every slice is done, so the executor must
+ *       run them in other threads than the one calling the reducer.  Posting
+ *       them to the event loop of the store using the reducer deadlocks,
+ *       since that loop is busy running the reducer itself.
+ *
+ * @note When wrapped in a `tracked_reducer()`, the store considers that any
+ *       part of the model may have changed, since the updates done by the
+ *       slices in other threads can not be recorded.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto pool    = boost::asio::thread_pool{};
+ *    auto reducer = lager::fork_join(
+ *        [&](auto fn) { boost::asio::post(pool, fn); },
+ *        lager::slice(lager::lenses::attr(&model::physics), physics::update),
+ *        lager::slice(lager::lenses::attr(&model::ai), ai::update));
+ *
+ * @endrst
+ */
+template <typename Executor, typename... Slices>
+auto fork_join(Executor&& executor, Slices&&... slices)
+{
+    static_assert(sizeof...(Slices) > 0, "at least one slice is required");
+    return detail::fork_join_reducer<std::decay_t<Executor>,
+                                     std::decay_t<Slices>...>{
+        std::forward<Executor>(executor),
+        std::make_tuple(std::forward<Slices>(slices)...)};
+}
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,362 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/deps.hpp>
+#include <lager/util.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace lager {
+
+//! @defgroup journal
+//! @{
+
+/*!
+ * How hard the `journal` tries to make an action durable before the store
+ * carries on processing it.
+ */
+enum class journal_durability
+{
+    //! Records are written to the file but never synced to disk, so they may
+    //! be lost if the system crashes.
+    none,
+    //! Records are synced to disk in groups, in the background.  The store
+    //! does not wait for this to happen.  Effects can use
+    //! `journal::on_durable()` when they need to.
+    group,
+    //! Like `group`, but the store waits for every action to be synced to
+    //! disk before reducing it.  A store thus syncs its actions one by one,
+    //! they are only grouped with the ones appended meanwhile by other
+    //! stores or threads sharing the journal.
+    sync,
+};
+
+struct journal_options
+{
+    journal_durability durability = journal_durability::group;
+    //! Sync as soon as this many records are pending.
+    std::size_t group_size = 64;
+    //! Sync at most this long after the first pending record was appended.
+    std::chrono::microseconds group_delay{1000};
+};
+
+struct journal_error : std::runtime_error
+{
+    using std::runtime_error::runtime_error;
+};
+
+/*!
+ * Write-ahead log of encoded actions.  Records are appended to a file by a
+ * background thread that commits them in groups: the file is synced to disk
+ * once for every `group_size` records or after `group_delay`, whichever
+ * comes first, so the throughput is not capped by the latency of the disk.
+ *
+ * Every record is stored as a 32-bit little endian length followed by the
+ * encoded action.  Use `read_journal()` to read them back.
+ *
+ * @see `with_journal()`
+ */
+class journal
+{
+public:
+    using sequence_t = std::uint64_t;
+
+    journal(const std::string& path, journal_options opts = {})
+        : opts_{opts}
+        , file_{std::fopen(path.c_str(), "ab")}
+    {
+        if (!file_)
+            throw journal_error{"could not open journal: " + path};
+        writer_ = std::thread{[this] { run(); }};
+    }
+
+    journal(const journal&) = delete;
+    journal& operator=(const journal&) = delete;
+
+    /*!
+     * Writes and syncs all the pending records before closing the file.
+     */
+    ~journal()
+    {
+        {
+            auto lock = std::unique_lock<std::mutex>{mutex_};
+            done_     = true;
+        }
+        pending_cv_.notify_one();
+        writer_.join();
+        std::fclose(file_);
+    }
+
+    const journal_options& options() const { return opts_; }
+
+    /*!
+     * Queues a record to be written and returns its sequence number.  Throws
+     * `journal_error` if writing a previous record failed.
+     */
+    sequence_t append(std::string record)
+    {
+        auto lock = std::unique_lock<std::mutex>{mutex_};
+        if (error_)
+            std::rethrow_exception(error_);
+        pending_.push_back(std::move(record));
+        auto seq = ++appended_;
+        if (pending_.size() == 1 || pending_.size() >= opts_.group_size ||
+            opts_.durability == journal_durability::sync)
+            pending_cv_.notify_one();
+        return seq;
+    }
+
+    /*!
+     * Sequence number of the last record appended.
+     */
+    sequence_t last_appended() const
+    {
+        auto lock = std::unique_lock<std::mutex>{mutex_};
+        return appended_;
+    }
+
+    /*!
+     * Sequence number of the last record that is durable, as far as the
+     * configured `journal_durability` goes.
+     */
+    sequence_t last_durable() const
+    {
+        auto lock = std::unique_lock<std::mutex>{mutex_};
+        return durable_;
+    }
+
+    /*!
+     * Blocks until the record `seq` is durable.
+     */
+    void wait_durable(sequence_t seq)
+    {
+        auto lock = std::unique_lock<std::mutex>{mutex_};
+        durable_cv_.wait(lock, [&] { return durable_ >= seq || error_; });
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+    void wait_durable() { wait_durable(last_appended()); }
+
+    /*!
+     * Calls `fn` once the record `seq` is durable.  This happens on the
+     * writer thread, or right away if the record is already durable.  Effects
+     * can use it to, for example, acknowledge a request only after the
+     * action that it caused can be recovered.
+     *
+     * If writing the records fails, the callbacks still waiting are dropped
+     * without being called, and later calls throw `journal_error`.
+     */
+    void on_durable(sequence_t seq, std::function<void()> fn)
+    {
+        {
+            auto lock = std::unique_lock<std::mutex>{mutex_};
+            if (error_)
+                std::rethrow_exception(error_);
+            if (durable_ < seq) {
+                callbacks_.emplace(seq, std::move(fn));
+                return;
+            }
+        }
+        fn();
+    }
+
+    void on_durable(std::function<void()> fn)
+    {
+        on_durable(last_appended(), std::move(fn));
+    }
+
+private:
+    void run()
+    {
+        auto lock = std::unique_lock<std::mutex>{mutex_};
+        while (true) {
+            pending_cv_.wait(lock, [&] { return done_ || !pending_.empty(); });
+            if (pending_.empty())
+                return;
+            if (opts_.durability != journal_durability::sync)
+                pending_cv_.wait_for(lock, opts_.group_delay, [&] {
+                    return done_ || pending_.size() >= opts_.group_size;
+                });
+            auto records = std::move(pending_);
+            auto last    = appended_;
+            pending_.clear();
+            lock.unlock();
+            auto error = std::exception_ptr{};
+            try {
+                write(records);
+            } catch (...) {
+                error = std::current_exception();
+            }
+            lock.lock();
+            if (error) {
+                // Nothing is written after a failure, so the records and
+                // callbacks still pending would never make it.
+                error_ = error;
+                pending_.clear();
+                auto dropped = std::move(callbacks_);
+                callbacks_.clear();
+                durable_cv_.notify_all();
+                lock.unlock();
+                return;
+            }
+            auto ready = std::vector<std::function<void()>>{};
+            durable_   = last;
+            auto end   = callbacks_.upper_bound(last);
+            for (auto it = callbacks_.begin(); it != end; ++it)
+                ready.push_back(std::move(it->second));
+            callbacks_.erase(callbacks_.begin(), end);
+            durable_cv_.notify_all();
+            lock.unlock();
+            for (auto& fn : ready)
+                fn();
+            lock.lock();
+        }
+    }
+
+    void write(const std::vector<std::string>& records)
+    {
+        for (auto& r : records) {
+            auto size = static_cast<std::uint32_t>(r.size());
+            unsigned char header[4] = {
+                static_cast<unsigned char>(size),
+                static_cast<unsigned char>(size >> 8),
+                static_cast<unsigned char>(size >> 16),
+                static_cast<unsigned char>(size >> 24),
+            };
+            if (std::fwrite(header, 1, 4, file_) != 4 ||
+                std::fwrite(r.data(), 1, r.size(), file_) != r.size())
+                throw journal_error{"could not write to the journal"};
+        }
+        if (std::fflush(file_) != 0)
+            throw journal_error{"could not write to the journal"};
+        if (opts_.durability != journal_durability::none && !sync_file())
+            throw journal_error{"could not sync the journal"};
+    }
+
+    bool sync_file()
+    {
+#if defined(_WIN32)
+        return _commit(_fileno(file_)) == 0;
+#else
+        return ::fsync(fileno(file_)) == 0;
+#endif
+    }
+
+    journal_options opts_;
+    std::FILE* file_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable pending_cv_;
+    std::condition_variable durable_cv_;
+    std::vector<std::string> pending_;
+    std::multimap<sequence_t, std::function<void()>> callbacks_;
+    sequence_t appended_ = 0;
+    sequence_t durable_  = 0;
+    std::exception_ptr error_;
+    bool done_ = false;
+
+    std::thread writer_;
+};
+
+/*!
+ * Reads the records of the journal at `path`, in the order they were
+ * appended.  A truncated record at the end, like one being written during a
+ * crash, is ignored.
+ */
+inline std::vector<std::string> read_journal(const std::string& path)
+{
+    auto file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        throw journal_error{"could not open journal: " + path};
+    auto result = std::vector<std::string>{};
+    unsigned char header[4];
+    while (std::fread(header, 1, 4, file) == 4) {
+        auto size = std::size_t{header[0]} | std::size_t{header[1]} << 8 |
+                    std::size_t{header[2]} << 16 |
+                    std::size_t{header[3]} << 24;
+        auto record = std::string(size, '\0');
+        if (std::fread(record.data(), 1, size, file) != size)
+            break;
+        result.push_back(std::move(record));
+    }
+    std::fclose(file);
+    return result;
+}
+
+/*!
+ * Store enhancer that appends every action to the journal `j`, encoded with
+ * `encode(action)`, which must return a `std::string`.  Actions are
+ * journaled right before they are reduced, in the thread of the event loop.
+ * The journal is also added to the dependencies of the store, so effects can
+ * use `journal::on_durable()` to wait for the action that caused them to be
+ * durable.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto j     = lager::journal{"actions.log"};
+ *    auto store = lager::make_store<action>(
+ *        model{}, update, event_loop,
+ *        lager::with_journal(j, [](auto&& act) { return encode(act); }));
+ *
+ * @endrst
+ */
+template <typename Encoder>
+auto with_journal(journal& j, Encoder encode)
+{
+    return [&j, encode](auto next) {
+        return [&j, encode, next](auto action,
+                                  auto&& model,
+                                  auto&& reducer,
+                                  auto&& loop,
+                                  auto&& deps) {
+            return next(
+                action,
+                LAGER_FWD(model),
+                [&j, encode, reducer = LAGER_FWD(reducer)](
+                    auto&& m, auto&& act) -> decltype(auto) {
+                    auto seq = j.append(encode(act));
+                    if (j.options().durability == journal_durability::sync)
+                        j.wait_durable(seq);
+                    return reducer(LAGER_FWD(m), LAGER_FWD(act));
+                },
+                LAGER_FWD(loop),
+                LAGER_FWD(deps).merge(make_deps(std::ref(j))));
+        };
+    };
+}
+
+//! @}
+
+} // namespace lager
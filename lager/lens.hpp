@@ -14,6 +14,7 @@ struct lens_i
     virtual ~lens_i()                                  = default;
     virtual Part view(Whole const&) const              = 0;
     virtual Whole set(Whole const&, Part const&) const = 0;
+    virtual Whole set(Whole&&, Part&&) const           = 0;
 };
 
 template <typename Lens, typename Whole, typename Part>
@@ -32,6 +33,11 @@ struct lens_holder : public lens_i<Whole, Part>
     {
         return ::lager::set(value, w, p);
     }
+
+    Whole set(Whole&& w, Part&& p) const override
+    {
+        return ::lager::set(value, std::move(w), std::move(p));
+    }
 };
 
 } // namespace detail
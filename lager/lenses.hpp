@@ -80,8 +80,9 @@ decltype(auto) view(LensT&& lens, T&& x)
 template <typename LensT, typename T, typename U>
 decltype(auto) set(LensT&& lens, T&& x, U&& v)
 {
-    return lens([&v](auto&&) { return detail::make_identity_functor(v); })(
-               std::forward<T>(x))
+    return lens([&v](auto&&) {
+               return detail::make_identity_functor(std::forward<U>(v));
+           })(std::forward<T>(x))
         .value;
 }
 
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <lager/util.hpp>
+#include <zug/compose.hpp>
+
+#include <utility>
+
+namespace lager {
+namespace lenses {
+
+//! @defgroup lenses
+//! @{
+
+/*!
+ * `Member -> Lens<soa<T, ..., Member, ...>, column_t<Member>>`
+ *
+ * Focuses on the column holding the values of the data `Member` of the
+ * entities of a `lager::soa`.
+ */
+template <auto Member>
+auto column()
+{
+    return zug::comp([](auto&& f) {
+        return [f = LAGER_FWD(f)](auto&& whole) {
+            return f(whole.template column<Member>())([&](auto&& col) {
+                return LAGER_FWD(whole).template set_column<Member>(
+                    LAGER_FWD(col));
+            });
+        };
+    });
+}
+
+//! @}
+
+} // namespace lenses
+} // namespace lager
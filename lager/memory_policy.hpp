@@ -0,0 +1,54 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <immer/heap/cpp_heap.hpp>
+#include <immer/heap/heap_policy.hpp>
+#include <immer/memory_policy.hpp>
+#include <immer/refcount/unsafe_refcount_policy.hpp>
+
+namespace lager {
+
+/*!
+ * Memory policy for immer containers that may be shared between threads.
+ * This is the default for the containers used by lager, like the history of
+ * the `debugger`, and uses atomic reference counts and a thread-safe free
+ * list heap.
+ */
+using default_memory_policy = immer::default_memory_policy;
+
+/*!
+ * Memory policy for immer containers that are confined to the thread of the
+ * event loop.  It uses plain reference counts and a free list heap without
+ * synchronization, which makes copying and releasing the containers much
+ * cheaper.
+ *
+ * @note Values using this policy must never be accessed from other threads,
+ *       not even to copy or destroy them.  The `http_debug_server` shares the
+ *       model of the debugger with its own threads, so it must be used with a
+ *       thread-safe policy.
+ */
+using loop_memory_policy =
+    immer::memory_policy<immer::unsafe_free_list_heap_policy<immer::cpp_heap>,
+                         immer::unsafe_refcount_policy>;
+
+/*!
+ * Like `default_memory_policy`, but with plain reference counts.  Nodes are
+ * still allocated with a thread-safe heap, so values may be destroyed in
+ * another thread as long as they are not shared.
+ */
+using unsafe_refcount_memory_policy =
+    immer::memory_policy<immer::default_heap_policy,
+                         immer::unsafe_refcount_policy>;
+
+} // namespace lager
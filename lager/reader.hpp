@@ -21,6 +21,8 @@
 
 #include <zug/meta/value_type.hpp>
 
+#include <cstdint>
+
 namespace lager {
 
 template <typename NodeT>
@@ -36,6 +38,13 @@ struct reader_mixin
     decltype(auto) operator*() const { return get(); }
     decltype(auto) operator->() const { return &get(); }
 
+    /*!
+     * Returns a number that grows every time that the value returned by
+     * `get()` changes.  Comparing it with a version seen before tells whether
+     * the value changed since then without comparing the values.
+     */
+    std::uint64_t version() const { return node_()->version(); }
+
     template <typename T>
     auto operator[](T&& t) const
     {
@@ -0,0 +1,198 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/context.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace lager {
+
+//! @defgroup replay
+//! @{
+
+/*!
+ * Snapshot of the model after the first `step` actions of a log were reduced.
+ */
+template <typename Model>
+struct replay_checkpoint
+{
+    std::size_t step;
+    Model model;
+};
+
+/*!
+ * Segment of a log whose replay did not produce the model of the checkpoint
+ * that ends it, which signals non-determinism in the reducer or a log or
+ * snapshot that does not match.
+ */
+template <typename Model>
+struct replay_mismatch
+{
+    //! Index of the checkpoint at which the segment starts.
+    std::size_t segment;
+    //! Step of the checkpoint at which the segment ends.
+    std::size_t step;
+    Model expected;
+    Model actual;
+};
+
+template <typename Model>
+struct replay_result
+{
+    //! Model after replaying the whole log.
+    Model model;
+    std::vector<replay_mismatch<Model>> mismatches;
+
+    bool ok() const { return mismatches.empty(); }
+};
+
+namespace detail {
+
+template <typename Reducer, typename Model, typename Actions>
+Model replay_range(const Reducer& reducer,
+                   Model m,
+                   const Actions& actions,
+                   std::size_t first,
+                   std::size_t last)
+{
+    for (auto i = first; i < last; ++i)
+        m = invoke_reducer(
+            reducer, std::move(m), actions[i], [](auto&&) {}, [] {});
+    return m;
+}
+
+template <typename Model, typename Actions>
+void check_checkpoints(const std::vector<replay_checkpoint<Model>>& checkpoints,
+                       const Actions& actions)
+{
+    if (checkpoints.empty())
+        throw std::invalid_argument{"replay needs at least one checkpoint"};
+    for (auto i = std::size_t{1}; i < checkpoints.size(); ++i)
+        if (checkpoints[i].step < checkpoints[i - 1].step)
+            throw std::invalid_argument{"replay checkpoints are not sorted"};
+    if (checkpoints.back().step > actions.size())
+        throw std::invalid_argument{"replay checkpoint is past the log"};
+}
+
+template <typename Fn>
+void parallel_for(std::size_t n, std::size_t concurrency, Fn&& fn)
+{
+    auto next  = std::atomic<std::size_t>{0};
+    auto mutex = std::mutex{};
+    auto error = std::exception_ptr{};
+    auto work  = [&] {
+        for (auto i = next++; i < n; i = next++) {
+            try {
+                fn(i);
+            } catch (...) {
+                auto lock = std::unique_lock<std::mutex>{mutex};
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    };
+    auto threads = std::vector<std::thread>{};
+    auto count   = std::min(std::max(concurrency, std::size_t{1}), n);
+    for (auto i = std::size_t{1}; i < count; ++i)
+        threads.emplace_back(work);
+    work();
+    for (auto& t : threads)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace detail
+
+/*!
+ * Returns the model after reducing the first `step` actions of the log
+ * `actions`.  It starts from the last checkpoint at or before `step`, so it
+ * only replays the actions since then.  Effects are not evaluated.
+ */
+template <typename Reducer, typename Actions, typename Model>
+Model replay_to(const Reducer& reducer,
+                const Actions& actions,
+                const std::vector<replay_checkpoint<Model>>& checkpoints,
+                std::size_t step)
+{
+    detail::check_checkpoints(checkpoints, actions);
+    if (step < checkpoints.front().step || step > actions.size())
+        throw std::out_of_range{"replay step is out of range"};
+    auto it = std::upper_bound(
+        checkpoints.begin(),
+        checkpoints.end(),
+        step,
+        [](std::size_t s, const auto& c) { return s < c.step; });
+    auto& from = *std::prev(it);
+    return detail::replay_range(reducer, from.model, actions, from.step, step);
+}
+
+/*!
+ * Replays the whole log `actions`, verifying that replaying every segment
+ * between two checkpoints results in the model of the checkpoint that ends
+ * it.  The segments are independent, so they are replayed in parallel in up
+ * to `concurrency` threads, and the reducer must be safe to call
+ * concurrently, as pure functions are.  Effects are not evaluated.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto actions = decode(lager::read_journal("actions.log"));
+ *    auto checkpoints = std::vector<lager::replay_checkpoint<model>>{...};
+ *    auto result = lager::replay_verify(update, actions, checkpoints);
+ *    for (auto& m : result.mismatches)
+ *        std::cerr << "non-determinism before step " << m.step << "\n";
+ *
+ * @endrst
+ */
+template <typename Reducer, typename Actions, typename Model>
+replay_result<Model>
+replay_verify(const Reducer& reducer,
+              const Actions& actions,
+              const std::vector<replay_checkpoint<Model>>& checkpoints,
+              std::size_t concurrency = std::thread::hardware_concurrency())
+{
+    detail::check_checkpoints(checkpoints, actions);
+    auto segments = checkpoints.size();
+    auto results  = std::vector<std::optional<Model>>(segments);
+    detail::parallel_for(segments, concurrency, [&](std::size_t i) {
+        auto last  = i + 1 < segments ? checkpoints[i + 1].step
+                                      : actions.size();
+        results[i] = detail::replay_range(
+            reducer, checkpoints[i].model, actions, checkpoints[i].step, last);
+    });
+    auto result = replay_result<Model>{std::move(*results.back()), {}};
+    for (auto i = std::size_t{}; i + 1 < segments; ++i) {
+        auto& next = checkpoints[i + 1];
+        if (!(*results[i] == next.model))
+            result.mismatches.push_back(
+                {i, next.step, next.model, std::move(*results[i])});
+    }
+    return result;
+}
+
+//! @}
+
+} // namespace lager
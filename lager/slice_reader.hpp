@@ -0,0 +1,97 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/constant.hpp>
+#include <lager/reader.hpp>
+#include <lager/with.hpp>
+
+#include <zug/meta/detected.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace lager {
+
+namespace detail {
+
+template <typename T>
+using const_make_t = decltype(std::declval<const T&>().make());
+
+template <typename T>
+auto as_slice_reader(T&& x)
+{
+    using type_t = std::decay_t<T>;
+    if constexpr (std::is_arithmetic_v<type_t>) {
+        return reader<type_t>{make_constant(x)};
+    } else if constexpr (zug::meta::is_detected<const_make_t, type_t>::value) {
+        return reader<typename type_t::value_type>{x.make()};
+    } else {
+        auto made = type_t{std::forward<T>(x)}.make();
+        return reader<typename decltype(made)::value_type>{std::move(made)};
+    }
+}
+
+} // namespace detail
+
+//! @defgroup cursors
+//! @{
+
+/*!
+ * Returns a reader with the elements of the sequence in the reader `r` in the
+ * range `[begin, end)`, like the rows that are visible in a scrolled list
+ * view.  The bounds can be integers or readers or cursors of integers, in
+ * which case the window follows them when they change.
+ *
+ * The sequence must provide `take()` and `drop()`, like
+ * `immer::flex_vector`, where these are logarithmic.  Recomputing the window
+ * and comparing it with the previous one is then proportional to the size of
+ * the window and not of the whole sequence.  Bounds outside of the sequence
+ * are clamped to its size.
+ *
+ * Not to be confused with `lager::slice()`, which focuses a reducer on a part
+ * of the model in `fork_join()`.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto first   = lager::state<std::size_t, lager::automatic_tag>{0};
+ *    auto visible =
+ *        lager::slice_reader(store[&model::rows], first,
+ *                            first.map([](auto x) { return x + 50; }));
+ *
+ * @endrst
+ */
+template <typename ReaderT, typename BeginT, typename EndT>
+auto slice_reader(ReaderT&& r, BeginT&& begin, EndT&& end)
+{
+    return with(detail::as_slice_reader(std::forward<ReaderT>(r)),
+                detail::as_slice_reader(std::forward<BeginT>(begin)),
+                detail::as_slice_reader(std::forward<EndT>(end)))
+        .map([](const auto& seq, auto b, auto e) {
+            auto size  = static_cast<std::size_t>(seq.size());
+            auto first = std::min(static_cast<std::size_t>(b), size);
+            auto last  = std::clamp(static_cast<std::size_t>(e), first, size);
+            if (first == 0 && last == size)
+                return seq;
+            return seq.take(last).drop(first);
+        })
+        .make();
+}
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,184 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+
+namespace lager {
+
+//! @defgroup snapshot
+//! @{
+
+/*!
+ * Saves snapshots of a model in a background thread.  Taking a snapshot with
+ * `request()` only copies the model, which for models built with Immer
+ * containers is cheap and does not depend on their size, and the slow work of
+ * serializing it happens elsewhere, so checkpointing does not stall the event
+ * loop.
+ *
+ * Snapshots are saved at most once every `min_interval`.  When more are
+ * requested in the meantime, only the latest one is saved.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto snapshots = lager::snapshotter<model>{
+ *        lager::cereal_snapshot_saver<model>("model.json"),
+ *        std::chrono::seconds{5}};
+ *    watch(store, [&](const model& m) { snapshots.request(m); });
+ *
+ * @endrst
+ *
+ * @see `lager/extra/cereal_snapshot.hpp` for a saver that serializes the
+ *      model with Cereal.
+ */
+template <typename Model>
+class snapshotter
+{
+public:
+    using model_t  = Model;
+    using saver_t  = std::function<void(const Model&)>;
+    using clock    = std::chrono::steady_clock;
+    using duration = clock::duration;
+
+    snapshotter(saver_t save, duration min_interval = {})
+        : save_{std::move(save)}
+        , min_interval_{min_interval}
+        , thread_{[this] { run(); }}
+    {}
+
+    snapshotter(const snapshotter&) = delete;
+    snapshotter& operator=(const snapshotter&) = delete;
+
+    /*!
+     * Saves the last requested snapshot, if any is pending, and stops the
+     * background thread.
+     */
+    ~snapshotter()
+    {
+        {
+            auto lock = std::unique_lock<std::mutex>{mutex_};
+            done_     = true;
+        }
+        requested_cv_.notify_one();
+        thread_.join();
+    }
+
+    /*!
+     * Schedules `m` to be saved, replacing the snapshot that is waiting to be
+     * saved, if any.  Rethrows the exception of the last save, if it failed.
+     */
+    void request(Model m)
+    {
+        {
+            auto lock = std::unique_lock<std::mutex>{mutex_};
+            if (auto err = std::exchange(error_, nullptr))
+                std::rethrow_exception(err);
+            latest_.emplace(std::move(m));
+            ++requested_;
+        }
+        requested_cv_.notify_one();
+    }
+
+    /*!
+     * Blocks until the snapshots requested so far are saved, without waiting
+     * for the `min_interval` to pass.
+     */
+    void flush()
+    {
+        auto lock   = std::unique_lock<std::mutex>{mutex_};
+        auto target = requested_;
+        ++flushing_;
+        requested_cv_.notify_one();
+        saved_cv_.wait(lock, [&] { return saved_ >= target; });
+        --flushing_;
+        if (auto err = std::exchange(error_, nullptr))
+            std::rethrow_exception(err);
+    }
+
+    /*!
+     * Number of snapshots that were saved.  This does not count the ones that
+     * were replaced by a later one before being saved.
+     */
+    std::size_t saved_count() const
+    {
+        auto lock = std::unique_lock<std::mutex>{mutex_};
+        return saved_count_;
+    }
+
+private:
+    void run()
+    {
+        auto lock = std::unique_lock<std::mutex>{mutex_};
+        while (true) {
+            requested_cv_.wait(lock, [&] { return done_ || latest_; });
+            if (!latest_)
+                return;
+            requested_cv_.wait_until(lock, last_save_ + min_interval_, [&] {
+                return done_ || flushing_ > 0;
+            });
+            auto target = requested_;
+            auto error  = std::exception_ptr{};
+            {
+                // The model is also released out of the lock, as freeing a
+                // big model can take a while.
+                auto m = std::move(*latest_);
+                latest_.reset();
+                lock.unlock();
+                try {
+                    save_(m);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+            }
+            lock.lock();
+            if (error)
+                error_ = error;
+            else
+                ++saved_count_;
+            saved_     = target;
+            last_save_ = clock::now();
+            saved_cv_.notify_all();
+        }
+    }
+
+    saver_t save_;
+    duration min_interval_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable requested_cv_;
+    std::condition_variable saved_cv_;
+    std::optional<Model> latest_;
+    std::size_t requested_   = 0;
+    std::size_t saved_       = 0;
+    std::size_t saved_count_ = 0;
+    std::size_t flushing_    = 0;
+    clock::time_point last_save_{};
+    std::exception_ptr error_;
+    bool done_ = false;
+
+    std::thread thread_;
+};
+
+//! @}
+
+} // namespace lager
@@ -0,0 +1,261 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <immer/array.hpp>
+#include <immer/array_transient.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace lager {
+
+namespace detail {
+
+template <auto Member>
+struct member_traits;
+
+template <typename T, typename Entity, T Entity::*Member>
+struct member_traits<Member>
+{
+    using entity_t = Entity;
+    using value_t  = T;
+};
+
+template <auto Member>
+using member_value_t = typename member_traits<Member>::value_t;
+
+template <auto A, auto B>
+constexpr bool same_member()
+{
+    if constexpr (std::is_same_v<decltype(A), decltype(B)>)
+        return A == B;
+    else
+        return false;
+}
+
+template <auto Member, auto... Members>
+constexpr std::size_t member_index()
+{
+    constexpr bool matches[] = {same_member<Member, Members>()...};
+    for (std::size_t i = 0; i < sizeof...(Members); ++i)
+        if (matches[i])
+            return i;
+    return sizeof...(Members);
+}
+
+} // namespace detail
+
+/*!
+ * Immutable sequence of `Entity` values, laid out as a struct of arrays: the
+ * values of each of the data `Members` of the entities are stored
+ * contiguously in their own column, an `immer::array`.  Like the immer
+ * containers, it has value semantics and is updated by returning new values.
+ *
+ * Accessing an entity assembles it from the columns, so it works with
+ * `lenses::at` and the `operator[]` of cursors.  Updating a single entity
+ * copies the columns unless they are uniquely owned, so simulations should
+ * rather update whole columns with `update()`, which passes contiguous
+ * ranges through the update function in a tight loop that compilers can
+ * vectorize.
+ *
+ * Every data member of `Entity` should be a column.  Entities are assembled
+ * by default constructing them and then assigning the columns, so other
+ * members always have their default value, and setting them is lost.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    struct particle { float x, v; };
+ *    using particles = lager::soa<particle, &particle::x, &particle::v>;
+ *
+ *    particles move(particles ps, float dt)
+ *    {
+ *        return std::move(ps).update<&particle::x, &particle::v>(
+ *            [=](float x, float v) { return x + v * dt; });
+ *    }
+ *
+ * @endrst
+ */
+template <typename Entity, auto... Members>
+class soa
+{
+    static_assert(sizeof...(Members) > 0, "at least one column is required");
+    static_assert(
+        (std::is_same_v<typename detail::member_traits<Members>::entity_t,
+                        Entity> &&
+         ...),
+        "columns must be data members of the entity");
+    static_assert(std::is_default_constructible_v<Entity>,
+                  "entities are assembled from a default constructed one");
+
+    template <auto Member>
+    static constexpr std::size_t index_v =
+        detail::member_index<Member, Members...>();
+
+public:
+    using value_type = Entity;
+    using size_type  = std::size_t;
+
+    template <auto Member>
+    using column_t = immer::array<detail::member_value_t<Member>>;
+
+    soa() = default;
+
+    soa(std::initializer_list<Entity> entities)
+        : columns_{make_column<Members>(entities)...}
+    {}
+
+    std::size_t size() const { return std::get<0>(columns_).size(); }
+    bool empty() const { return size() == 0; }
+
+    /*!
+     * Returns the entity at `index`, with the members that are not columns
+     * default constructed.
+     */
+    Entity operator[](std::size_t index) const
+    {
+        auto r = Entity{};
+        ((r.*Members = column<Members>()[index]), ...);
+        return r;
+    }
+
+    Entity at(std::size_t index) const
+    {
+        if (index >= size())
+            throw std::out_of_range{"lager::soa::at"};
+        return (*this)[index];
+    }
+
+    template <auto Member>
+    const column_t<Member>& column() const
+    {
+        static_assert(index_v<Member> < sizeof...(Members), "no such column");
+        return std::get<index_v<Member>>(columns_);
+    }
+
+    /*!
+     * Returns a copy with the column for `Member` replaced by `col`, which
+     * must have as many values as there are entities.
+     */
+    template <auto Member>
+    soa set_column(column_t<Member> col) const&
+    {
+        return soa{*this}.template set_column<Member>(std::move(col));
+    }
+
+    template <auto Member>
+    soa set_column(column_t<Member> col) &&
+    {
+        static_assert(index_v<Member> < sizeof...(Members), "no such column");
+        assert(col.size() == size() && "columns must have the same size");
+        std::get<index_v<Member>>(columns_) = std::move(col);
+        return std::move(*this);
+    }
+
+    soa push_back(const Entity& entity) const&
+    {
+        return soa{*this}.push_back(entity);
+    }
+
+    soa push_back(const Entity& entity) &&
+    {
+        ((column_mut<Members>() =
+              std::move(column_mut<Members>()).push_back(entity.*Members)),
+         ...);
+        return std::move(*this);
+    }
+
+    soa set(std::size_t index, const Entity& entity) const&
+    {
+        return soa{*this}.set(index, entity);
+    }
+
+    soa set(std::size_t index, const Entity& entity) &&
+    {
+        ((column_mut<Members>() =
+              std::move(column_mut<Members>()).set(index, entity.*Members)),
+         ...);
+        return std::move(*this);
+    }
+
+    /*!
+     * Returns a copy where every value of the column for `Member` is replaced
+     * by `fn(value, inputs...)`, where `inputs` are the values of the same
+     * entity in the columns for `Inputs`.  The column is updated in place
+     * when it is uniquely owned.
+     */
+    template <auto Member, auto... Inputs, typename Fn>
+    soa update(Fn&& fn) const&
+    {
+        return soa{*this}.template update<Member, Inputs...>(
+            std::forward<Fn>(fn));
+    }
+
+    template <auto Member, auto... Inputs, typename Fn>
+    soa update(Fn&& fn) &&
+    {
+        // The inputs are kept alive, so they are not modified even when one
+        // of them is the column being updated.
+        auto inputs = std::make_tuple(column<Inputs>()...);
+        auto n      = size();
+        auto t      = std::move(column_mut<Member>()).transient();
+        std::apply(
+            [&](auto&... ins) {
+                update_column(n, t.data_mut(), fn, ins.data()...);
+            },
+            inputs);
+        column_mut<Member>() = std::move(t).persistent();
+        return std::move(*this);
+    }
+
+    bool operator==(const soa& other) const
+    {
+        return columns_ == other.columns_;
+    }
+    bool operator!=(const soa& other) const { return !(*this == other); }
+
+private:
+    template <auto Member>
+    static column_t<Member>
+    make_column(std::initializer_list<Entity> entities)
+    {
+        auto t = column_t<Member>{}.transient();
+        for (auto& e : entities)
+            t.push_back(e.*Member);
+        return std::move(t).persistent();
+    }
+
+    template <auto Member>
+    column_t<Member>& column_mut()
+    {
+        return std::get<index_v<Member>>(columns_);
+    }
+
+    template <typename T, typename Fn, typename... Ins>
+    static void update_column(std::size_t n, T* out, Fn& fn, const Ins*... ins)
+    {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = fn(out[i], ins[i]...);
+    }
+
+    std::tuple<column_t<Members>...> columns_;
+};
+
+} // namespace lager
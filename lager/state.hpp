@@ -20,6 +20,11 @@
 #include <lager/tags.hpp>
 #include <lager/util.hpp>
 
+#include <algorithm>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 namespace lager {
 
 namespace detail {
@@ -27,8 +32,74 @@ namespace detail {
 template <typename T>
 using state_base = root_node<T, cursor_node>;
 
+/*!
+ * Propagates the changes of roots using the `deferred_tag`.  The roots that
+ * change while a propagation is running are queued, and they are sent down
+ * and notified together after it, until no more changes are made.
+ */
+class deferred_propagation
+{
+public:
+    static deferred_propagation& instance()
+    {
+        thread_local auto self = deferred_propagation{};
+        return self;
+    }
+
+    void propagate(std::weak_ptr<reader_node_base> node)
+    {
+        auto queued = std::any_of(
+            pending_.begin(), pending_.end(), [&](auto& other) {
+                return !other.owner_before(node) && !node.owner_before(other);
+            });
+        if (!queued)
+            pending_.push_back(std::move(node));
+        if (running_)
+            return;
+        running_ = true;
+        try {
+            while (!pending_.empty()) {
+                auto nodes = std::vector<std::shared_ptr<reader_node_base>>{};
+                for (auto& wnode : pending_)
+                    if (auto n = wnode.lock())
+                        nodes.push_back(std::move(n));
+                pending_.clear();
+                for (auto& n : nodes)
+                    n->send_down();
+                for (auto& n : nodes)
+                    n->notify();
+            }
+        } catch (...) {
+            pending_.clear();
+            running_ = false;
+            throw;
+        }
+        running_ = false;
+    }
+
+private:
+    bool running_ = false;
+    std::vector<std::weak_ptr<reader_node_base>> pending_;
+};
+
 template <typename T, typename TagT = transactional_tag>
-class state_node : public state_base<T>
+class state_node;
+
+struct no_shared_from_this
+{};
+
+// Only roots using the `deferred_tag` need to refer to themselves, when
+// they are queued in the `deferred_propagation`.
+template <typename T, typename TagT>
+using state_node_self_base =
+    std::conditional_t<std::is_same_v<TagT, deferred_tag>,
+                       std::enable_shared_from_this<state_node<T, TagT>>,
+                       no_shared_from_this>;
+
+template <typename T, typename TagT>
+class state_node
+    : public state_base<T>
+    , public state_node_self_base<T, TagT>
 {
     using base_t = state_base<T>;
 
@@ -42,18 +113,24 @@ public:
     void send_up(const value_type& value) final
     {
         this->push_down(value);
-        if constexpr (std::is_same_v<TagT, automatic_tag>) {
-            this->send_down();
-            this->notify();
-        }
+        propagate();
     }
 
     void send_up(value_type&& value) final
     {
         this->push_down(std::move(value));
+        propagate();
+    }
+
+private:
+    void propagate()
+    {
         if constexpr (std::is_same_v<TagT, automatic_tag>) {
             this->send_down();
             this->notify();
+        } else if constexpr (std::is_same_v<TagT, deferred_tag>) {
+            deferred_propagation::instance().propagate(
+                this->weak_from_this());
         }
     }
 };
@@ -0,0 +1,329 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/access.hpp>
+#include <lager/detail/no_value.hpp>
+#include <lager/detail/nodes.hpp>
+#include <lager/detail/smart_lens.hpp>
+#include <lager/detail/xform_nodes.hpp>
+#include <lager/lenses.hpp>
+#include <lager/reader.hpp>
+
+#include <zug/compose.hpp>
+#include <zug/meta/pack.hpp>
+#include <zug/meta/value_type.hpp>
+#include <zug/transducer/filter.hpp>
+#include <zug/transducer/map.hpp>
+
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace lager {
+
+template <typename Deriv>
+struct static_expr_mixin;
+
+template <typename Xform, typename... Parents>
+class static_xform_expr;
+
+template <typename... Exprs>
+class static_with_expr;
+
+namespace detail {
+
+template <typename T>
+struct is_static_with : std::false_type
+{};
+
+template <typename... Exprs>
+struct is_static_with<static_with_expr<Exprs...>> : std::true_type
+{};
+
+} // namespace detail
+
+//! @defgroup static_graph
+//! @{
+
+/*!
+ * Leaf of a static graph, standing for the value of the reader that the graph
+ * is attached to with `make_static()`.  It only points to that value, which
+ * is not copied.
+ */
+template <typename T>
+class static_source : public static_expr_mixin<static_source<T>>
+{
+public:
+    using value_type = T;
+
+    bool update(const T& source)
+    {
+        value_ = &source;
+        return true;
+    }
+
+    const T& value() const { return *value_; }
+
+private:
+    const T* value_ = nullptr;
+};
+
+/*!
+ * Stage of a static graph that feeds the values of its parent stages through
+ * a transducer.  It keeps the last value that it produced and it only tells
+ * its children that it changed when the new one differs.  When none of the
+ * parents changed, it does not even run the transducer.
+ */
+template <typename Xform, typename... Parents>
+class static_xform_expr
+    : public static_expr_mixin<static_xform_expr<Xform, Parents...>>
+{
+    using down_rf_t = decltype(std::declval<Xform>()(detail::send_down_rf));
+
+public:
+    using value_type =
+        zug::result_of_t<Xform, typename Parents::value_type...>;
+
+    static_xform_expr(Xform xform, Parents... parents)
+        : parents_{std::move(parents)...}
+        , step_{std::move(xform)(detail::send_down_rf)}
+    {}
+
+    template <typename Source>
+    bool update(const Source& source)
+    {
+        auto changed = std::apply(
+            [&](auto&... ps) { return (false | ... | ps.update(source)); },
+            parents_);
+        if (!changed && value_)
+            return false;
+        auto sink = detail::initial_value_sink<value_type>{};
+        std::apply([&](auto&... ps) { step_(&sink, ps.value()...); },
+                   parents_);
+        if (!sink.value) {
+            if (value_)
+                return false;
+            if constexpr (std::is_default_constructible_v<value_type>)
+                sink.value.emplace();
+            else
+                throw no_value_error{};
+        }
+        if (value_ && !detail::has_changed(*sink.value, *value_))
+            return false;
+        value_ = std::move(sink.value);
+        return true;
+    }
+
+    const value_type& value() const { return *value_; }
+
+    const std::tuple<Parents...>& parents() const { return parents_; }
+
+private:
+    std::tuple<Parents...> parents_;
+    down_rf_t step_;
+    std::optional<value_type> value_;
+};
+
+/*!
+ * Operations to build a static graph out of its stages, mirroring the ones
+ * of readers.
+ */
+template <typename Deriv>
+struct static_expr_mixin
+{
+    template <typename Xform>
+    auto xform(Xform&& xf) const
+    {
+        using xform_t = std::decay_t<Xform>;
+        if constexpr (detail::is_static_with<Deriv>::value)
+            return std::apply(
+                [&](auto... ps) {
+                    return static_xform_expr<xform_t, decltype(ps)...>{
+                        std::forward<Xform>(xf), std::move(ps)...};
+                },
+                deriv_().exprs());
+        else
+            return static_xform_expr<xform_t, Deriv>{std::forward<Xform>(xf),
+                                                     deriv_()};
+    }
+
+    template <typename... Fns>
+    auto map(Fns&&... fns) const
+    {
+        return xform(zug::comp(zug::map(std::forward<Fns>(fns))...));
+    }
+
+    template <typename Pred>
+    auto filter(Pred&& pred) const
+    {
+        return xform(zug::filter(std::forward<Pred>(pred)));
+    }
+
+    template <typename Lens>
+    auto zoom(Lens&& l) const
+    {
+        auto xf = zug::map([l = std::forward<Lens>(l)](const auto& whole) {
+            return ::lager::view(l, whole);
+        });
+        return static_xform_expr<decltype(xf), Deriv>{std::move(xf), deriv_()};
+    }
+
+    template <typename Key>
+    auto operator[](Key&& k) const
+    {
+        using value_t = typename Deriv::value_type;
+        return zoom(detail::smart_lens<value_t>::make(std::forward<Key>(k)));
+    }
+
+private:
+    const Deriv& deriv_() const { return static_cast<const Deriv&>(*this); }
+};
+
+template <typename... Exprs>
+class static_with_expr : public static_expr_mixin<static_with_expr<Exprs...>>
+{
+    using impl_t = static_xform_expr<zug::identity_t, Exprs...>;
+
+    impl_t impl_;
+
+public:
+    using value_type = typename impl_t::value_type;
+
+    static_with_expr(Exprs... exprs)
+        : impl_{zug::identity, std::move(exprs)...}
+    {}
+
+    template <typename Source>
+    bool update(const Source& source)
+    {
+        return impl_.update(source);
+    }
+
+    const value_type& value() const { return impl_.value(); }
+
+    const std::tuple<Exprs...>& exprs() const { return impl_.parents(); }
+};
+
+/*!
+ * Combines stages of a static graph into one whose value is a tuple with
+ * their values, like `with()` does for readers.  Transforming the result with
+ * `map()` or `xform()` passes the values of the stages as separate arguments.
+ */
+template <typename... Exprs>
+auto static_with(Exprs&&... exprs)
+{
+    return static_with_expr<std::decay_t<Exprs>...>{
+        std::forward<Exprs>(exprs)...};
+}
+
+//! @}
+
+namespace detail {
+
+template <typename Expr, typename Parent>
+class static_graph_node
+    : public inner_node<typename Expr::value_type,
+                        zug::meta::pack<Parent>,
+                        reader_node>
+{
+    using base_t = inner_node<typename Expr::value_type,
+                              zug::meta::pack<Parent>,
+                              reader_node>;
+
+    Expr expr_;
+
+    static auto init(Expr& expr, const std::tuple<std::shared_ptr<Parent>>& ps)
+    {
+        expr.update(std::get<0>(ps)->current());
+        return expr.value();
+    }
+
+public:
+    static_graph_node(Expr expr, std::tuple<std::shared_ptr<Parent>> parents)
+        : base_t{init(expr, parents), std::move(parents)}
+        , expr_{std::move(expr)}
+    {}
+
+    void recompute() final
+    {
+        if (expr_.update(std::get<0>(this->parents())->current()))
+            this->push_down(expr_.value());
+    }
+};
+
+template <typename T>
+struct is_static_expr : std::is_base_of<static_expr_mixin<T>, T>
+{};
+
+} // namespace detail
+
+//! @defgroup static_graph
+//! @{
+
+/*!
+ * Attaches a static graph to the reader `r`, returning a reader with the
+ * value of its final stage.  The graph is built at compile time out of
+ * `static_source`, `static_with()` and the `xform`, `map`, `filter`, `zoom`
+ * and `[]` operations of its stages, and it is evaluated as a single node of
+ * the dynamic graph.  Updating it is an inlined pass through all the stages
+ * in which the ones whose inputs did not change are skipped, without the
+ * virtual calls and the reference counted links between dynamic nodes.
+ *
+ * The `graph` can be an expression built from a `static_source` of the type
+ * of the reader, or a function taking such a source and returning the
+ * expression:
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    lager::reader<hud> h = lager::make_static(store, [](auto game) {
+ *        auto p = game[&model::player];
+ *        return lager::static_with(p[&player::health],
+ *                                  p[&player::ammo].map(to_string))
+ *            .map([](int health, std::string ammo) {
+ *                return hud{health, ammo};
+ *            });
+ *    });
+ *
+ * @endrst
+ *
+ * @note Stages are values, so a stage used by several others is evaluated
+ *       once for each of them.
+ */
+template <typename ReaderT, typename Graph>
+auto make_static(ReaderT&& r, Graph&& graph)
+{
+    auto parent   = detail::access::node(std::forward<ReaderT>(r).make());
+    using value_t = typename decltype(parent)::element_type::value_type;
+    auto expr     = [&] {
+        if constexpr (detail::is_static_expr<std::decay_t<Graph>>::value)
+            return std::forward<Graph>(graph);
+        else
+            return std::forward<Graph>(graph)(static_source<value_t>{});
+    }();
+    using expr_t = std::decay_t<decltype(expr)>;
+    using node_t =
+        detail::static_graph_node<expr_t,
+                                  typename decltype(parent)::element_type>;
+    auto node = detail::link_to_parents(std::make_shared<node_t>(
+        std::move(expr), std::make_tuple(std::move(parent))));
+    return reader_base<node_t>{std::move(node)};
+}
+
+//! @}
+
+} // namespace lager
@@ -19,6 +19,7 @@
 
 #include <zug/compose.hpp>
 
+#include <functional>
 #include <memory>
 #include <type_traits>
 
@@ -37,6 +38,33 @@ struct store_node_base : public root_node<Model, reader_node>
 
     virtual void recompute() final {}
     virtual void dispatch(action_t action) = 0;
+
+    const dirty_path* tracked_path() const final
+    {
+        static const auto root = dirty_path{};
+        return &root;
+    }
+
+    const dirty_set* dirty_paths() const final
+    {
+        return dirty_.all() ? nullptr : &dirty_;
+    }
+
+protected:
+    /*!
+     * Returns an object recording the parts of the model updated by the
+     * reducer while alive.  The updates recorded before are kept until they
+     * are sent down.
+     */
+    dirty_tracker track_updates()
+    {
+        if (!base_t::needs_send_down())
+            dirty_.clear();
+        return {dirty_, typeid(Model)};
+    }
+
+private:
+    dirty_set dirty_;
 };
 
 } // namespace detail
@@ -136,8 +164,13 @@ private:
         void dispatch(action_t action) override
         {
             loop.post([this, action = std::move(action)] {
+                auto tracking_reducer = [&](auto&& model, auto&& action) {
+                    auto tracker = base_t::track_updates();
+                    return std::invoke(
+                        reducer, LAGER_FWD(model), LAGER_FWD(action));
+                };
                 base_t::push_down(invoke_reducer<deps_t>(
-                    reducer,
+                    tracking_reducer,
                     base_t::current(),
                     std::move(action),
                     [&](auto&& effect) {
@@ -19,4 +19,22 @@ struct transactional_tag
 struct automatic_tag
 {};
 
+/*!
+ * For `state`, like `automatic_tag`, but values set while watchers are being
+ * notified of changes in states with this tag are not propagated right away.
+ * Instead, they are queued and propagated together once the notification
+ * finishes.
+ */
+struct deferred_tag
+{};
+
+/*!
+ * Tags for `watch_on()`: deliver every value to the watcher, or only the most
+ * recent one when the executor falls behind.
+ */
+struct every_value_tag
+{};
+struct latest_value_tag
+{};
+
 } // namespace lager
@@ -0,0 +1,88 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/last_inputs.hpp>
+
+#include <zug/compose.hpp>
+#include <zug/skip.hpp>
+#include <zug/util.hpp>
+
+#include <chrono>
+#include <optional>
+
+namespace lager {
+
+/*!
+ * Transducer that lets an input through only when no other input was
+ * received during the preceding `interval`, filtering out bursts of quick
+ * successive changes.  Time is measured with `Clock` whenever an input is
+ * received.
+ *
+ * Nodes are only recomputed when their parents change, so on its own this
+ * is the leading edge variant of debouncing: the last value of a burst is
+ * not delivered after the burst settles.  To get it, pass as a second input
+ * a reader of `Clock::time_point` that is committed periodically, like a
+ * `sensor` of `Clock::now()`.  Inputs where only this tick changed do not
+ * restart the interval, and once it has elapsed they deliver the current
+ * value, which is the last one of the burst.  The tick is not passed on.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto now    = lager::make_sensor([] { return clock::now(); });
+ *    auto search = lager::with(query, now)
+ *                      .xform(lager::debounce<clock>(300ms))
+ *                      .make();
+ *
+ * @endrst
+ *
+ * @note The state is kept in the reducing function, like in `sample`.
+ *       Recomputations where neither the value nor the tick changed repeat
+ *       the previous outcome.
+ */
+template <typename Clock = std::chrono::steady_clock, typename Duration>
+auto debounce(Duration interval)
+{
+    using time_point = typename Clock::time_point;
+    return zug::comp([interval](auto&& step) {
+        return [step = ZUG_FWD(step),
+                interval,
+                last      = std::optional<time_point>{},
+                last_tick = std::optional<time_point>{},
+                delivered = false,
+                inputs    = detail::last_inputs{}](
+                   auto&& s, auto&& i, auto&&... tick) mutable {
+            static_assert(sizeof...(tick) <= 1,
+                          "debounce takes a value and, optionally, a tick");
+            auto value_changed = inputs.changed(i);
+            auto tick_changed  = false;
+            if constexpr (sizeof...(tick) == 1) {
+                auto t       = time_point{tick...};
+                tick_changed = !last_tick || *last_tick != t;
+                last_tick    = t;
+            }
+            if (value_changed || tick_changed) {
+                auto now  = Clock::now();
+                delivered = !last || now - *last >= interval;
+                if (value_changed)
+                    last = now;
+            }
+            return delivered ? zug::call(step, ZUG_FWD(s), ZUG_FWD(i))
+                             : zug::skip(step, ZUG_FWD(s), ZUG_FWD(i));
+        };
+    });
+}
+
+} // namespace lager
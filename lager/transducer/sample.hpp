@@ -0,0 +1,66 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/last_inputs.hpp>
+
+#include <zug/compose.hpp>
+#include <zug/skip.hpp>
+#include <zug/util.hpp>
+
+#include <chrono>
+#include <optional>
+
+namespace lager {
+
+/*!
+ * Transducer that lets through at most one input per `interval`, dropping
+ * the inputs received in between.  Time is measured with `Clock` whenever
+ * an input is received.
+ *
+ * Nodes are only recomputed when their parents change.  In order to get the
+ * derived values at a fixed cadence even when the sampled value stops
+ * changing, combine it with a reader that is committed periodically (e.g. a
+ * `sensor` of the frame time) and discard it afterwards.
+ *
+ * @note Unlike most Zug transducers, the state is kept in the reducing
+ *       function, since that is what nodes keep between recomputations.
+ *       Recomputations with the same inputs as the previous one repeat its
+ *       outcome, without measuring the time again.
+ */
+template <typename Clock = std::chrono::steady_clock, typename Duration>
+auto sample(Duration interval)
+{
+    return zug::comp([interval](auto&& step) {
+        return [step = ZUG_FWD(step),
+                interval,
+                last   = std::optional<typename Clock::time_point>{},
+                passed = false,
+                inputs = detail::last_inputs{}](auto&& s,
+                                                auto&&... is) mutable {
+            if (inputs.changed(is...)) {
+                auto now = Clock::now();
+                passed   = !last || now - *last >= interval;
+                if (passed)
+                    last = now;
+            }
+            if (passed) {
+                return zug::call(step, ZUG_FWD(s), ZUG_FWD(is)...);
+            } else {
+                return zug::skip(step, ZUG_FWD(s), ZUG_FWD(is)...);
+            }
+        };
+    });
+}
+
+} // namespace lager
@@ -0,0 +1,91 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/last_inputs.hpp>
+
+#include <zug/compose.hpp>
+#include <zug/util.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <utility>
+
+namespace lager {
+
+/*!
+ * Transducer that produces the mean of the last `n` inputs, converted to
+ * `T`.  Every input updates a running sum, so each step is constant time.
+ *
+ * @note The window is kept in the reducing function, which is what nodes
+ *       keep between recomputations.  Inputs equal to the previous one are
+ *       not added to the window again, since nodes may be recomputed more
+ *       than once per change.
+ */
+template <typename T = double>
+auto window_mean(std::size_t n)
+{
+    assert(n > 0);
+    return zug::comp([n](auto&& step) {
+        return [step   = ZUG_FWD(step),
+                n,
+                window = std::deque<T>{},
+                sum    = T{},
+                last   = detail::last_inputs{}](auto&& s, auto&& x) mutable {
+            if (!last.changed(x))
+                return step(ZUG_FWD(s), sum / static_cast<T>(window.size()));
+            window.push_back(ZUG_FWD(x));
+            sum = sum + window.back();
+            if (window.size() > n) {
+                sum = sum - window.front();
+                window.pop_front();
+            }
+            return step(ZUG_FWD(s), sum / static_cast<T>(window.size()));
+        };
+    });
+}
+
+/*!
+ * Transducer that produces the maximum of the last `n` inputs, converted to
+ * `T`, which must be less-than comparable.  The window only keeps the
+ * candidates that may still become the maximum, in decreasing order, so each
+ * step is amortized constant time.
+ *
+ * @note The window is kept in the reducing function, and repeated inputs are
+ *       skipped, like in `window_mean`.
+ */
+template <typename T>
+auto window_max(std::size_t n)
+{
+    assert(n > 0);
+    return zug::comp([n](auto&& step) {
+        return [step   = ZUG_FWD(step),
+                n,
+                window = std::deque<std::pair<std::size_t, T>>{},
+                count  = std::size_t{},
+                last   = detail::last_inputs{}](auto&& s, auto&& x) mutable {
+            if (!last.changed(x))
+                return step(ZUG_FWD(s), window.front().second);
+            auto v = T(ZUG_FWD(x));
+            while (!window.empty() && !(v < window.back().second))
+                window.pop_back();
+            window.emplace_back(count++, std::move(v));
+            if (window.front().first + n < count)
+                window.pop_front();
+            return step(ZUG_FWD(s), window.front().second);
+        };
+    });
+}
+
+} // namespace lager
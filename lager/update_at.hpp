@@ -0,0 +1,150 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <lager/detail/dirty.hpp>
+#include <lager/util.hpp>
+
+#include <zug/meta/detected.hpp>
+
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace lager {
+
+//! @defgroup update_at
+//! @{
+
+/*!
+ * Path to a part of a model, as a sequence of pointers to data members and
+ * indices.  @see `path()`
+ */
+template <typename... Keys>
+struct path_t
+{
+    static_assert((detail::is_path_key_v<Keys> && ...),
+                  "paths contain indices or members");
+
+    std::tuple<Keys...> keys;
+};
+
+/*!
+ * Returns the path to a part of a model, to be used with `update_at()`.
+ *
+ * @rst
+ *
+ * .. code-block:: c++
+ *
+ *    auto p = lager::path(&model::todos, 3, &todo::done);
+ *
+ * @endrst
+ */
+template <typename... Keys>
+path_t<Keys...> path(Keys... ks)
+{
+    return {std::make_tuple(ks...)};
+}
+
+namespace detail {
+
+template <typename T, typename Key>
+using update_method_t =
+    decltype(std::declval<T>().update(std::declval<Key>(), identity));
+
+template <typename Whole, typename Fn, typename Key, typename... Keys>
+std::decay_t<Whole> update_in(Whole&& whole, Fn& fn, Key k, Keys... ks)
+{
+    auto update_part = [&](auto&& part) {
+        if constexpr (sizeof...(Keys) == 0)
+            return fn(LAGER_FWD(part));
+        else
+            return update_in(LAGER_FWD(part), fn, ks...);
+    };
+    if constexpr (std::is_member_object_pointer_v<Key>) {
+        auto r = std::forward<Whole>(whole);
+        r.*k   = update_part(std::move(r.*k));
+        return r;
+    } else {
+        // Like `lenses::at`, out of range indices leave the model untouched.
+        try {
+            (void) whole.at(k);
+        } catch (std::out_of_range const&) {
+            return std::forward<Whole>(whole);
+        }
+        if constexpr (zug::meta::is_detected<update_method_t, Whole, Key>::
+                          value) {
+            return std::forward<Whole>(whole).update(k, update_part);
+        } else {
+            auto r     = std::forward<Whole>(whole);
+            auto& part = r.at(k);
+            part       = update_part(std::move(part));
+            return r;
+        }
+    }
+}
+
+} // namespace detail
+
+/*!
+ * Returns the `model` with the part at `path` updated with `fn`, that takes
+ * the old part and returns the new one.  When called from a reducer wrapped
+ * with `tracked_reducer()`, the path is recorded, so the store only
+ * propagates the change to the cursors built with `operator[]` whose path
+ * leads to, or goes through, the updated part.
+ */
+template <typename Model, typename Fn, typename... Keys>
+std::decay_t<Model> update_at(Model&& model, const path_t<Keys...>& path, Fn fn)
+{
+    if (auto tracker = detail::dirty_tracker::current()) {
+        tracker->add<std::decay_t<Model>>(std::apply(
+            [](auto... ks) {
+                return detail::dirty_path{detail::make_path_key(ks)...};
+            },
+            path.keys));
+    }
+    if constexpr (sizeof...(Keys) == 0) {
+        return fn(std::forward<Model>(model));
+    } else {
+        return std::apply(
+            [&](auto... ks) {
+                return detail::update_in(std::forward<Model>(model), fn, ks...);
+            },
+            path.keys);
+    }
+}
+
+/*!
+ * Wraps a `reducer` that only changes the model through `update_at()`, so a
+ * store using it knows which parts of the model were updated by each
+ * action.  Without it, the store assumes that any part may have changed.
+ *
+ * @note Updating the model in other ways from the wrapped reducer, or from
+ *       functions it calls, leaves cursors with stale values.
+ */
+template <typename Reducer>
+auto tracked_reducer(Reducer&& reducer)
+{
+    return [reducer = std::forward<Reducer>(reducer)](
+               auto&& model, auto&& action) -> decltype(auto) {
+        if (auto tracker = detail::dirty_tracker::current())
+            tracker->track<std::decay_t<decltype(model)>>();
+        return std::invoke(reducer, LAGER_FWD(model), LAGER_FWD(action));
+    };
+}
+
+//! @}
+
+} // namespace lager
@@ -12,24 +12,163 @@
 
 #pragma once
 
+#include <lager/detail/budget.hpp>
 #include <lager/detail/signal.hpp>
+#include <lager/tags.hpp>
 
 #include <zug/meta/value_type.hpp>
 
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
 
 namespace lager {
 
+/*!
+ * Priority of a watcher.  Watchers of higher priority are notified first.
+ * Watchers of `low` priority may be deferred when notifying within a
+ * `notify_budget`.
+ */
+enum class watch_priority : int
+{
+    low    = -1,
+    normal = 0,
+    high   = 1,
+};
+
+namespace detail {
+
+template <typename T, typename Executor, typename Callback, typename TagT>
+struct async_watcher;
+
+template <typename T, typename Executor, typename Callback>
+struct async_watcher<T, Executor, Callback, every_value_tag>
+{
+    Executor executor;
+    std::shared_ptr<Callback> callback;
+
+    void operator()(const T& value)
+    {
+        executor.post(
+            [callback = callback, value = value] { (*callback)(value); });
+    }
+};
+
+template <typename T, typename Executor, typename Callback>
+struct async_watcher<T, Executor, Callback, latest_value_tag>
+{
+    struct state_t
+    {
+        state_t(Callback cb)
+            : callback{std::move(cb)}
+        {}
+
+        Callback callback;
+        std::mutex mutex;
+        std::optional<T> pending;
+    };
+
+    Executor executor;
+    std::shared_ptr<state_t> state;
+
+    void operator()(const T& value)
+    {
+        auto lock      = std::unique_lock<std::mutex>{state->mutex};
+        auto scheduled = state->pending.has_value();
+        state->pending = value;
+        lock.unlock();
+        if (!scheduled) {
+            executor.post([state = state] {
+                auto lock  = std::unique_lock<std::mutex>{state->mutex};
+                auto value = std::move(*state->pending);
+                state->pending.reset();
+                lock.unlock();
+                state->callback(value);
+            });
+        }
+    }
+};
+
+template <typename T, typename Callback>
+struct deferrable_watcher
+{
+    struct state_t
+    {
+        state_t(Callback cb)
+            : callback{std::move(cb)}
+        {}
+
+        Callback callback;
+        std::optional<T> pending;
+    };
+
+    std::shared_ptr<state_t> state;
+
+    deferrable_watcher(Callback cb)
+        : state{std::make_shared<state_t>(std::move(cb))}
+    {}
+
+    void operator()(const T& value)
+    {
+        auto budget = notify_budget_base::current();
+        if (budget && budget->expired()) {
+            auto scheduled = state->pending.has_value();
+            state->pending = value;
+            if (!scheduled) {
+                budget->defer([weak = std::weak_ptr<state_t>{state}] {
+                    if (auto state = weak.lock()) {
+                        if (state->pending) {
+                            auto value = std::move(*state->pending);
+                            state->pending.reset();
+                            state->callback(value);
+                        }
+                    }
+                });
+            }
+        } else {
+            state->pending.reset();
+            state->callback(value);
+        }
+    }
+};
+
+template <typename TagT, typename T, typename Executor, typename Callback>
+auto make_async_watcher(Executor&& ex, Callback&& cb)
+{
+    using executor_t = std::decay_t<Executor>;
+    using callback_t = std::decay_t<Callback>;
+    using watcher_t  = async_watcher<T, executor_t, callback_t, TagT>;
+    if constexpr (std::is_same_v<TagT, latest_value_tag>) {
+        using state_t = typename watcher_t::state_t;
+        return watcher_t{
+            std::forward<Executor>(ex),
+            std::make_shared<state_t>(std::forward<Callback>(cb))};
+    } else {
+        return watcher_t{
+            std::forward<Executor>(ex),
+            std::make_shared<callback_t>(std::forward<Callback>(cb))};
+    }
+}
+
+} // namespace detail
+
 template <typename NodeT>
 class watchable_base : private NodeT::signal_type::forwarder_type
 {
-    using node_ptr_t   = std::shared_ptr<NodeT>;
-    using value_t      = zug::meta::value_t<NodeT>;
-    using base_t       = typename NodeT::signal_type::forwarder_type;
-    using connection_t = typename base_t::connection;
+    using node_ptr_t        = std::shared_ptr<NodeT>;
+    using value_t           = zug::meta::value_t<NodeT>;
+    using base_t            = typename NodeT::signal_type::forwarder_type;
+    using connection_t      = typename base_t::connection;
+    using diff_base_t       = typename NodeT::diff_signal_type::forwarder_type;
+    using diff_connection_t = typename diff_base_t::connection;
 
     node_ptr_t node_;
     std::vector<connection_t> conns_;
+    base_t low_base_;
+    base_t high_base_;
+    diff_base_t diff_base_;
+    std::vector<diff_connection_t> diff_conns_;
 
     const node_ptr_t& node() const& { return node_; }
     node_ptr_t&& node() && { return std::move(node_); }
@@ -65,28 +204,42 @@ public:
 
     watchable_base& operator=(const watchable_base& other) noexcept
     {
-        base_t::unlink();
+        unlink_();
         node_ = other.node_;
-        if (!base_t::empty() && node_)
-            node_->observers().add(*this);
+        relink_();
         return *this;
     }
 
     watchable_base& operator=(watchable_base&& other) noexcept
     {
-        base_t::unlink();
+        unlink_();
         node_ = std::move(other.node_);
-        if (!base_t::empty() && node_)
-            node_->observers().add(*this);
+        relink_();
         return *this;
     }
 
+    /*!
+     * Invokes @a callback with the new value every time it changes.  The
+     * watchers of a node are invoked in order of @a priority, also across
+     * different readers of the same node, and then in connection order.
+     */
     template <typename CallbackT>
-    auto&& watch(CallbackT&& callback)
+    auto&& watch(CallbackT&& callback,
+                 watch_priority priority = watch_priority::normal)
     {
-        if (base_t::empty() && node_)
-            node_->observers().add(*this);
-        conns_.push_back(base_t::connect(std::forward<CallbackT>(callback)));
+        auto& fwd = forwarder_(priority);
+        if (fwd.empty() && node_) {
+            fwd.priority = static_cast<int>(priority);
+            node_->observers().add(fwd);
+        }
+        if (priority < watch_priority::normal) {
+            using watcher_t =
+                detail::deferrable_watcher<value_t, std::decay_t<CallbackT>>;
+            conns_.push_back(
+                fwd.connect(watcher_t{std::forward<CallbackT>(callback)}));
+        } else {
+            conns_.push_back(fwd.connect(std::forward<CallbackT>(callback)));
+        }
         return *this;
     }
 
@@ -97,16 +250,141 @@ public:
         return watch(std::forward<CallbackT>(callback));
     }
 
-    void nudge() { base_t::operator()(node()->last()); }
+    /*!
+     * Like `watch()`, but the callback receives both the previously notified
+     * value and the new one, as in `callback(old, new)`.  The callback may
+     * also take a third argument, the change set between both values, as
+     * computed by `lager::changes_traits` (see `lager/diff.hpp`).  The change
+     * set is computed at most once per notification and shared by all the
+     * diff watchers of the underlying node.
+     *
+     * @note The old value is only retained by the node while there are diff
+     *       watchers connected to it, so the first notification after
+     *       connecting may be missed if the value had already been
+     *       propagated but not yet notified.
+     */
+    template <typename CallbackT>
+    auto&& watch_diff(CallbackT&& callback)
+    {
+        using callback_t = std::decay_t<CallbackT>;
+        if (diff_base_.empty() && node_)
+            node_->diff_observers().add(diff_base_);
+        diff_conns_.push_back(diff_base_.connect(
+            [callback = std::forward<CallbackT>(callback)](
+                auto&& diff) mutable {
+                if constexpr (std::is_invocable_v<callback_t&,
+                                                  const value_t&,
+                                                  const value_t&>) {
+                    callback(diff.old_value(), diff.new_value());
+                } else {
+                    callback(
+                        diff.old_value(), diff.new_value(), diff.changes());
+                }
+            }));
+        return *this;
+    }
+
+    /*!
+     * Like `watch()`, but the callback is not invoked during the notification.
+     * Instead, a copy of the value is taken and the callback is posted to the
+     * @a executor, which can be any type with a `post()` method, like the
+     * event loops in `lager/event_loop/`.  This is useful for slow watchers
+     * (logging, exporting metrics, writing to disk...)
+     *
+     * With `every_value_tag`, every value is delivered in order.  With
+     * `latest_value_tag`, when the executor falls behind, the intermediate
+     * values that it did not get to process are skipped and only the most
+     * recent one is delivered.
+     *
+     * @note The callback is invoked from the executor, that should evaluate
+     *       the posted functions serially.
+     */
+    template <typename TagT = every_value_tag,
+              typename Executor,
+              typename CallbackT>
+    auto&& watch_on(Executor&& executor, CallbackT&& callback)
+    {
+        return watch(detail::make_async_watcher<TagT, value_t>(
+            std::forward<Executor>(executor),
+            std::forward<CallbackT>(callback)));
+    }
+
+    void nudge()
+    {
+        high_base_(node()->last());
+        base_t::operator()(node()->last());
+        low_base_(node()->last());
+    }
+
+private:
+    // Watchers connect to the forwarder for their priority, and each
+    // forwarder is a slot of that priority in the node, so the node orders
+    // the watchers of all its readers.
+    base_t& forwarder_(watch_priority priority)
+    {
+        return priority < watch_priority::normal   ? low_base_
+               : priority > watch_priority::normal ? high_base_
+                                                   : normal_base_();
+    }
+
+    base_t& normal_base_() { return *this; }
+
+    void unlink_()
+    {
+        base_t::unlink();
+        low_base_.unlink();
+        high_base_.unlink();
+        diff_base_.unlink();
+    }
+
+    void relink_()
+    {
+        if (node_) {
+            for (auto fwd : {&high_base_, &normal_base_(), &low_base_})
+                if (!fwd->empty())
+                    node_->observers().add(*fwd);
+            if (!diff_base_.empty())
+                node_->diff_observers().add(diff_base_);
+        }
+    }
 };
 
 /*!
  * Watch changes through a reader using callback @callback.
  */
 template <typename ReaderT, typename CallbackT>
-auto watch(ReaderT&& value, CallbackT&& callback)
+auto watch(ReaderT&& value,
+           CallbackT&& callback,
+           watch_priority priority = watch_priority::normal)
+{
+    return value.watch(std::forward<CallbackT>(callback), priority);
+}
+
+/*!
+ * Watch changes through a reader using callback @callback, which is invoked
+ * from @a executor.  @see `watchable_base::watch_on`.
+ */
+template <typename ReaderT,
+          typename Executor,
+          typename CallbackT,
+          typename TagT = every_value_tag>
+auto watch_on(ReaderT&& value,
+              Executor&& executor,
+              CallbackT&& callback,
+              TagT = {})
+{
+    return value.template watch_on<TagT>(std::forward<Executor>(executor),
+                                         std::forward<CallbackT>(callback));
+}
+
+/*!
+ * Watch changes through a reader using callback @callback, which receives the
+ * old and new values.  @see `watchable_base::watch_diff`.
+ */
+template <typename ReaderT, typename CallbackT>
+auto watch_diff(ReaderT&& value, CallbackT&& callback)
 {
-    return value.watch(std::forward<CallbackT>(callback));
+    return value.watch_diff(std::forward<CallbackT>(callback));
 }
 
 } // namespace lager
@@ -13,11 +13,13 @@
 #pragma once
 
 #include <lager/detail/lens_nodes.hpp>
+#include <lager/detail/member_nodes.hpp>
 #include <lager/detail/merge_nodes.hpp>
 #include <lager/detail/xform_nodes.hpp>
 
 #include <lager/tags.hpp>
 
+#include <zug/meta/detected.hpp>
 #include <zug/transducer/filter.hpp>
 #include <zug/transducer/map.hpp>
 
@@ -115,6 +117,8 @@ template <template <class> class Result,
 class with_wxform_expr;
 template <template <class> class Result, typename Lens, typename... Nodes>
 class with_lens_expr;
+template <template <class> class Result, typename Path, typename Node>
+class with_member_expr;
 
 template <template <typename Node> class Result, typename... Nodes>
 auto make_with_expr(std::tuple<std::shared_ptr<Nodes>...> nodes)
@@ -150,6 +154,31 @@ auto make_with_lens_expr(Lens lens, std::tuple<std::shared_ptr<Nodes>...> nodes)
     return {std::move(lens), std::move(nodes)};
 }
 
+template <template <class> class Result, typename Path, typename Node>
+auto make_with_member_expr(Path path, std::tuple<std::shared_ptr<Node>> nodes)
+    -> with_member_expr<Result, Path, Node>
+{
+    return {std::move(path), std::move(nodes)};
+}
+
+template <typename Whole, typename Member>
+using member_access_t =
+    decltype(std::declval<const Whole&>().*std::declval<Member>());
+
+template <typename Expr, typename Member>
+using zoom_member_t =
+    decltype(std::declval<Expr>().zoom_member(std::declval<Member>()));
+
+/*!
+ * Whether zooming into `Member` of the `Whole` value of the expression `Expr`
+ * can be done with a `member_node`, that does not copy the part.
+ */
+template <typename Expr, typename Whole, typename Member>
+constexpr bool can_zoom_member_v =
+    std::is_member_object_pointer_v<Member> &&
+    zug::meta::is_detected<member_access_t, Whole, Member>::value &&
+    zug::meta::is_detected<zoom_member_t, Expr, Member>::value;
+
 template <typename Result>
 struct is_reader_base : std::false_type
 {};
@@ -168,8 +197,12 @@ public:
     auto operator[](T&& k) &&
     {
         using value_t = typename decltype(deriv_().make())::value_type;
-        auto lens     = smart_lens<value_t>::make(std::forward<T>(k));
-        return deriv_().zoom(lens);
+        if constexpr (can_zoom_member_v<Deriv, value_t, std::decay_t<T>>) {
+            return deriv_().zoom_member(std::forward<T>(k));
+        } else {
+            auto lens = smart_lens<value_t>::make(std::forward<T>(k));
+            return deriv_().zoom(lens);
+        }
     }
 
     template <typename T>
@@ -258,6 +291,15 @@ public:
         return make_with_lens_expr<Result>(std::forward<Lens>(l),
                                            std::move(nodes_));
     }
+
+    template <typename Member,
+              std::size_t N                 = sizeof...(Nodes),
+              std::enable_if_t<N == 1, int> = 0>
+    auto zoom_member(Member m) &&
+    {
+        return make_with_member_expr<Result>(
+            member_path<Member>{std::make_tuple(m)}, std::move(nodes_));
+    }
 };
 
 template <typename Xform, typename... Nodes>
@@ -414,6 +456,66 @@ public:
     }
 };
 
+template <template <class> class Result, typename Path, typename Node>
+class with_member_expr
+    : public with_expr_base<with_member_expr<Result, Path, Node>>
+{
+    friend class with_expr_base<with_member_expr>;
+
+    Path path_;
+    std::tuple<std::shared_ptr<Node>> nodes_;
+
+    template <typename T>
+    using result_t = Result<T>;
+
+    auto make_reader_node_() &&
+    {
+        return make_member_reader_node(std::move(path_), std::move(nodes_));
+    }
+
+    auto make_cursor_node_() &&
+    {
+        return make_member_cursor_node(std::move(path_), std::move(nodes_));
+    }
+
+public:
+    template <typename P, typename Ns>
+    with_member_expr(P&& p, Ns&& n)
+        : path_{std::forward<P>(p)}
+        , nodes_{std::forward<Ns>(n)}
+    {}
+
+    template <typename Member>
+    auto zoom_member(Member m) &&
+    {
+        return make_with_member_expr<Result>(path_.then(m), std::move(nodes_));
+    }
+
+    // Other transformations go through a member node, so the transducers
+    // and lenses get the part without copying it.
+
+    template <typename Xf>
+    auto xform(Xf&& xf) &&
+    {
+        return make_with_xform_expr(
+            std::forward<Xf>(xf),
+            std::make_tuple(std::move(*this).make_reader_node_()));
+    }
+
+    template <typename Xf, typename WXf>
+    auto xform(Xf&& xf, WXf&& wxf) &&
+    {
+        return std::move(*this).make().xform(std::forward<Xf>(xf),
+                                             std::forward<WXf>(wxf));
+    }
+
+    template <typename Lens>
+    auto zoom(Lens&& l) &&
+    {
+        return std::move(*this).make().zoom(std::forward<Lens>(l));
+    }
+};
+
 template <typename... ReaderTs>
 auto with_aux(reader_mixin<ReaderTs>&&... ins)
 {
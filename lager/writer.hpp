@@ -17,6 +17,8 @@
 #include <lager/detail/smart_lens.hpp>
 #include <lager/watch.hpp>
 
+#include <optional>
+
 namespace lager {
 
 template <typename NodeT>
@@ -40,6 +42,45 @@ struct writer_mixin
         return node_()->send_up(std::forward<Fn>(fn)(node_()->current()));
     }
 
+    /*!
+     * Like `update()`, but `fn` takes the current value by mutable reference
+     * and modifies it in place.  The value is moved out of the node and sent
+     * up as an rvalue, and so are the values of its parents, so updating a
+     * uniquely owned value does not copy it.  Cursors viewing a member of
+     * their parent still take a copy of it.
+     *
+     * When `fn` throws the value is rolled back, like with `update()`.  The
+     * last value is used for that unless there are changes not committed
+     * yet, in which case the current value is copied before calling `fn`.
+     */
+    template <typename Fn>
+    void update_inplace(Fn&& fn)
+    {
+        using value_t = typename std::decay_t<decltype(*node_())>::value_type;
+        auto node     = node_();
+        auto original = node->needs_send_down()
+                            ? std::optional<value_t>{node->current()}
+                            : std::nullopt;
+        auto value    = node->take_current();
+        try {
+            std::forward<Fn>(fn)(value);
+        } catch (...) {
+            // Nodes viewing their value in the parent gave us a copy, the
+            // others need theirs back.  Derived nodes then recompute it from
+            // their parents, but roots keep the one pushed here.
+            if (node->current_moved()) {
+                if (original)
+                    node->push_down(std::move(*original));
+                else
+                    node->push_down(node->last());
+                node->refresh();
+            }
+            throw;
+        }
+        node->send_up(std::move(value));
+        node->restore_current();
+    }
+
     template <typename T>
     auto operator[](T&& t) const
     {
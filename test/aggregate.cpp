@@ -0,0 +1,133 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/aggregate.hpp>
+#include <lager/state.hpp>
+
+#include <immer/map.hpp>
+#include <immer/set.hpp>
+
+#include <string>
+
+#include "spies.hpp"
+
+using namespace lager;
+
+namespace {
+
+struct task
+{
+    std::string owner;
+    int cost  = 0;
+    bool done = false;
+
+    bool operator==(const task& x) const
+    {
+        return owner == x.owner && cost == x.cost && done == x.done;
+    }
+    bool operator!=(const task& x) const { return !(*this == x); }
+};
+
+using tasks_t = immer::map<int, task>;
+
+} // namespace
+
+TEST_CASE("aggregate, count_if")
+{
+    auto st   = make_state(immer::set<int>{}.insert(1).insert(2).insert(3));
+    auto odds = count_if(st, [](int x) { return x % 2 == 1; });
+    CHECK(odds.get() == 2);
+
+    st.set(st.get().insert(5).insert(6).erase(1));
+    commit(st);
+    CHECK(odds.get() == 2);
+
+    st.set(st.get().insert(7));
+    commit(st);
+    CHECK(odds.get() == 3);
+}
+
+TEST_CASE("aggregate, sum_by")
+{
+    auto st    = make_state(tasks_t{}.set(1, {"a", 3}).set(2, {"b", 4}));
+    auto total = sum_by(st, [](auto&& kv) { return kv.second.cost; });
+    CHECK(total.get() == 7);
+
+    st.set(st.get().set(1, {"a", 10}).set(3, {"c", 1}).erase(2));
+    commit(st);
+    CHECK(total.get() == 11);
+}
+
+TEST_CASE("aggregate, group_by")
+{
+    auto st = make_state(
+        tasks_t{}.set(1, {"a", 1}).set(2, {"b", 2}).set(3, {"a", 3}));
+    auto by_owner = group_by(st, [](auto&& kv) { return kv.second.owner; });
+    CHECK(by_owner->size() == 2);
+    CHECK(by_owner->at("a").size() == 2);
+    CHECK(by_owner->at("b").size() == 1);
+
+    st.set(st.get().set(2, {"a", 2}));
+    commit(st);
+    CHECK(by_owner->size() == 1);
+    CHECK(by_owner->at("a").size() == 3);
+    CHECK(by_owner->at("a").at(2).cost == 2);
+
+    st.set(st.get().erase(1).set(4, {"c", 4}));
+    commit(st);
+    CHECK(by_owner->size() == 2);
+    CHECK(by_owner->at("a").size() == 2);
+    CHECK(by_owner->at("c").size() == 1);
+}
+
+TEST_CASE("aggregate, only notifies when the aggregate changes")
+{
+    auto st   = make_state(tasks_t{}.set(1, {"a", 1}).set(2, {"b", 2}));
+    auto done = count_if(st, [](auto&& kv) { return kv.second.done; });
+    auto s    = testing::spy();
+    watch(done, s);
+
+    st.set(st.get().set(1, {"a", 5}));
+    commit(st);
+    CHECK(s.count() == 0);
+
+    st.set(st.get().set(1, {"a", 5, true}));
+    commit(st);
+    CHECK(s.count() == 1);
+    CHECK(done.get() == 1);
+}
+
+TEST_CASE("aggregate, custom aggregate")
+{
+    auto st    = make_state(immer::set<int>{}.insert(1).insert(2));
+    auto calls = 0;
+    auto sum   = aggregate(
+        st,
+        0,
+        [&](int acc, int x) {
+            ++calls;
+            return acc + x;
+        },
+        [&](int acc, int x) {
+            ++calls;
+            return acc - x;
+        });
+    CHECK(sum.get() == 3);
+    CHECK(calls == 2);
+
+    st.set(st.get().insert(10));
+    commit(st);
+    CHECK(sum.get() == 13);
+    CHECK(calls == 3);
+}
@@ -0,0 +1,105 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/batch.hpp>
+#include <lager/event_loop/manual.hpp>
+#include <lager/fixed_timestep.hpp>
+#include <lager/store.hpp>
+
+#include <chrono>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace {
+
+using ms = std::chrono::duration<float, std::milli>;
+
+} // namespace
+
+TEST_CASE("fixed_timestep, accumulates time")
+{
+    auto t = lager::fixed_timestep<>{ms{10}};
+    CHECK(t.advance(ms{4}) == 0);
+    CHECK(t.advance(ms{4}) == 0);
+    CHECK(t.advance(ms{4}) == 1);
+    CHECK(t.alpha() == Approx(0.2f));
+    CHECK(t.advance(ms{25}) == 2);
+    CHECK(t.alpha() == Approx(0.7f));
+}
+
+TEST_CASE("fixed_timestep, clamps the number of steps")
+{
+    auto t = lager::fixed_timestep<std::chrono::milliseconds>{
+        std::chrono::milliseconds{10}, 3};
+    CHECK(t.advance(std::chrono::milliseconds{100}) == 3);
+    CHECK(t.alpha() == 0.f);
+    CHECK(t.advance(std::chrono::milliseconds{15}) == 1);
+    CHECK(t.alpha() == Approx(0.5f));
+}
+
+TEST_CASE("with_batches, reduces a batch in one go")
+{
+    auto reducer = [](int model, int action) { return model + action; };
+    auto store   = lager::make_store<int>(
+        0, reducer, lager::with_manual_event_loop{}, lager::with_batches());
+
+    auto values = std::vector<int>{};
+    watch(store, [&](int x) { values.push_back(x); });
+
+    store.dispatch(lager::batch_action<int>{{1, 2, 3}});
+    CHECK(store.get() == 6);
+    CHECK(values == std::vector<int>{6});
+
+    store.dispatch(4);
+    CHECK(store.get() == 10);
+    CHECK(values == (std::vector<int>{6, 10}));
+
+    store.dispatch(lager::batch_action<int>{});
+    CHECK(values == (std::vector<int>{6, 10}));
+}
+
+TEST_CASE("with_batches, runs the effects in order")
+{
+    auto log     = std::vector<int>{};
+    auto reducer = [&](int model, int action) {
+        auto eff = lager::effect<int>{[&log, action](auto&&) {
+            log.push_back(action);
+        }};
+        return std::pair{model + action, eff};
+    };
+    auto store = lager::make_store<int>(
+        0, reducer, lager::with_manual_event_loop{}, lager::with_batches());
+
+    store.dispatch(lager::batch_action<int>{{3, 1, 2}});
+    CHECK(store.get() == 6);
+    CHECK(log == (std::vector<int>{3, 1, 2}));
+}
+
+TEST_CASE("with_batches, converts batches of compatible actions")
+{
+    using action_t = std::variant<int, std::string>;
+    auto reducer   = [](int model, action_t action) {
+        return std::visit(lager::visitor{[&](int x) { return model + x; },
+                                         [&](const std::string& x) {
+                                             return model + int(x.size());
+                                         }},
+                          action);
+    };
+    auto store = lager::make_store<action_t>(
+        0, reducer, lager::with_manual_event_loop{}, lager::with_batches());
+
+    store.dispatch(lager::batch_action<int>{{1, 2}});
+    CHECK(store.get() == 3);
+}
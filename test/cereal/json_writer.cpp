@@ -0,0 +1,201 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/debug/cereal/immer_vector.hpp>
+#include <lager/debug/cereal/json_writer.hpp>
+#include <lager/debug/cereal/struct.hpp>
+
+#include <cereal/archives/json.hpp>
+#include <cereal/types/optional.hpp>
+#include <cereal/types/string.hpp>
+#include <immer/vector.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <variant>
+
+namespace {
+
+struct point
+{
+    int x;
+    int y;
+};
+LAGER_CEREAL_STRUCT(point, (x)(y));
+
+struct empty_t
+{};
+LAGER_CEREAL_STRUCT(empty_t);
+
+struct doc
+{
+    std::string name;
+    immer::vector<point> points;
+    std::optional<double> scale;
+};
+LAGER_CEREAL_STRUCT(doc, (name)(points)(scale));
+
+enum class color
+{
+    red,
+    green
+};
+
+template <typename T>
+std::string to_json(const T& x)
+{
+    auto r = std::string{};
+    {
+        auto ar = lager::json_writer{r};
+        ar(cereal::make_nvp("x", x));
+    }
+    return r;
+}
+
+} // namespace
+
+TEST_CASE("basic values")
+{
+    CHECK(to_json(42) == R"({"x":42})");
+    CHECK(to_json(-3l) == R"({"x":-3})");
+    CHECK(to_json(true) == R"({"x":true})");
+    CHECK(to_json(0.5) == R"({"x":0.5})");
+    CHECK(to_json(1.0) == R"({"x":1.0})");
+    CHECK(to_json(std::nan("")) == R"({"x":null})");
+    CHECK(to_json(color::green) == R"({"x":1})");
+    CHECK(to_json(std::string{"foo"}) == R"({"x":"foo"})");
+}
+
+TEST_CASE("strings are escaped")
+{
+    CHECK(to_json(std::string{"a\"b\\c\nd\x01"}) ==
+          R"({"x":"a\"b\\c\nd\u0001"})");
+}
+
+TEST_CASE("structs")
+{
+    CHECK(to_json(point{1, 2}) == R"({"x":{"x":1,"y":2}})");
+    CHECK(to_json(empty_t{}) == R"({"x":{}})");
+    CHECK(to_json(doc{"d", {point{1, 2}}, 2.0}) ==
+          R"({"x":{"name":"d","points":[{"x":1,"y":2}],)"
+          R"("scale":{"nullopt":false,"data":2.0}}})");
+}
+
+TEST_CASE("containers")
+{
+    CHECK(to_json(immer::vector<int>{}) == R"({"x":[]})");
+    CHECK(to_json(immer::vector<int>{1, 2, 3}) == R"({"x":[1,2,3]})");
+    CHECK(to_json(std::map<std::string, int>{{"a", 1}}) ==
+          R"({"x":[{"key":"a","value":1}]})");
+    CHECK(to_json(std::optional<int>{}) == R"({"x":{"nullopt":true}})");
+    CHECK(to_json(immer::box<int>{5}) == R"({"x":{"value":5}})");
+    CHECK(to_json(std::make_pair(1, 2)) == R"({"x":{"first":1,"second":2}})");
+    CHECK(to_json(std::make_tuple(1, "a")) == R"({"x":[1,"a"]})");
+}
+
+TEST_CASE("variants")
+{
+    using variant_t = std::variant<int, point>;
+    auto name = cereal::detail::get_type_name<point>();
+    CHECK(to_json(variant_t{point{1, 2}}) ==
+          R"({"x":{"type":")" + name + R"(","data":{"x":1,"y":2}}})");
+    CHECK(to_json(variant_t{3}) == R"({"x":{"type":"int","data":3}})");
+}
+
+TEST_CASE("unnamed values")
+{
+    auto r = std::string{};
+    {
+        auto ar = lager::json_writer{r};
+        ar(1, cereal::make_nvp("a", 2), 3);
+    }
+    CHECK(r == R"({"value0":1,"a":2,"value1":3})");
+}
+
+TEST_CASE("buffers can be reused")
+{
+    auto r = std::string{};
+    {
+        auto ar = lager::json_writer{r};
+        ar(cereal::make_nvp("a", 1));
+    }
+    auto capacity = r.capacity();
+    r.clear();
+    {
+        auto ar = lager::json_writer{r};
+        ar(cereal::make_nvp("b", 2));
+    }
+    CHECK(r == R"({"b":2})");
+    CHECK(r.capacity() == capacity);
+}
+
+TEST_CASE("can be read back with cereal")
+{
+    auto x = doc{"foo", {point{1, 2}, point{3, 4}}, 0.5};
+    auto r = std::string{};
+    {
+        auto ar = lager::json_writer{r};
+        ar(cereal::make_nvp("doc", x));
+    }
+    auto y  = doc{};
+    auto is = std::istringstream{r};
+    {
+        auto ar = cereal::JSONInputArchive{is};
+        ar(cereal::make_nvp("doc", y));
+    }
+    CHECK(y.name == x.name);
+    CHECK(y.points.size() == 2);
+    CHECK(y.points[1].y == 4);
+    CHECK(y.scale == x.scale);
+}
+
+TEST_CASE("benchmark against cereal", "[.benchmark]")
+{
+    auto x = doc{"benchmark", {}, 1.5};
+    for (auto i = 0; i < 200000; ++i)
+        x.points = std::move(x.points).push_back(point{i, -i});
+
+    auto time = [](auto fn) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (auto i = 0; i < 10; ++i)
+            fn();
+        auto t1 = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(t1 - t0).count() /
+               10;
+    };
+
+    auto buffer    = std::string{};
+    auto writer_ms = time([&] {
+        buffer.clear();
+        auto ar = lager::json_writer{buffer};
+        ar(cereal::make_nvp("model", x));
+    });
+    auto cereal_ms = time([&] {
+        auto s = std::ostringstream{};
+        {
+            auto ar = cereal::JSONOutputArchive{s};
+            ar(cereal::make_nvp("model", x));
+        }
+        return s.str();
+    });
+    std::cout << "json_writer: " << writer_ms << " ms, "
+              << "cereal::JSONOutputArchive: " << cereal_ms << " ms, "
+              << buffer.size() << " bytes" << std::endl;
+    CHECK(!buffer.empty());
+}
@@ -36,6 +36,20 @@ TEST_CASE("automatic")
     CHECK(store.get().value == 1);
 }
 
+TEST_CASE("version")
+{
+    // the model needs to be equality comparable to tell it did not change
+    auto store = lager::make_store<int>(
+        0, [](int, int x) { return x; }, lager::with_manual_event_loop{});
+    auto v = store.version();
+
+    store.dispatch(1);
+    CHECK(store.version() == v + 1);
+
+    store.dispatch(1);
+    CHECK(store.version() == v + 1);
+}
+
 TEST_CASE("basic")
 {
     auto viewed = std::optional<counter::model>{std::nullopt};
@@ -18,10 +18,13 @@
 #include <lager/state.hpp>
 #include <lager/writer.hpp>
 
+#include <zug/transducer/filter.hpp>
+
 #include <boost/fusion/include/adapt_struct.hpp>
 #include <boost/fusion/include/comparison.hpp>
 
 #include <immer/vector.hpp>
+#include <stdexcept>
 #include <vector>
 
 #include "spies.hpp"
@@ -95,6 +98,214 @@ TEST_CASE("out, setting")
     CHECK(42 == st.get());
 }
 
+TEST_CASE("out, updating in place")
+{
+    auto st = make_state(std::vector<int>{1, 2});
+    auto o  = writer<std::vector<int>>{st};
+
+    o.update_inplace([](auto& v) { v.push_back(3); });
+    o.update_inplace([](auto& v) { v.push_back(4); });
+    commit(st);
+    CHECK(st.get() == (std::vector<int>{1, 2, 3, 4}));
+}
+
+namespace {
+
+struct copy_counter
+{
+    static inline int copies = 0;
+
+    std::vector<int> data;
+
+    copy_counter()                          = default;
+    copy_counter(copy_counter&&)            = default;
+    copy_counter& operator=(copy_counter&&) = default;
+    copy_counter(const copy_counter& x)
+        : data{x.data}
+    {
+        ++copies;
+    }
+    copy_counter& operator=(const copy_counter& x)
+    {
+        data = x.data;
+        ++copies;
+        return *this;
+    }
+
+    bool operator==(const copy_counter& x) const { return data == x.data; }
+    bool operator!=(const copy_counter& x) const { return data != x.data; }
+};
+
+struct big_model
+{
+    copy_counter big;
+    int small = 0;
+
+    bool operator==(const big_model& x) const
+    {
+        return big == x.big && small == x.small;
+    }
+    bool operator!=(const big_model& x) const { return !(*this == x); }
+};
+
+} // namespace
+
+TEST_CASE("out, updating in place does not copy")
+{
+    auto st = make_state(copy_counter{});
+
+    copy_counter::copies = 0;
+    st.update_inplace([](auto& v) { v.data.push_back(42); });
+    CHECK(copy_counter::copies == 0);
+
+    commit(st);
+    CHECK(st->data == std::vector<int>{42});
+}
+
+TEST_CASE("zooming, updating in place")
+{
+    auto st = make_state(big_model{});
+    auto c  = st[&big_model::big].make();
+
+    copy_counter::copies = 0;
+    c.update_inplace([](auto& v) { v.data.push_back(42); });
+    // the member cursor views the part inside its parent, so it is updated
+    // on a copy, but the parent itself is moved
+    CHECK(copy_counter::copies == 1);
+
+    commit(st);
+    CHECK(c->data == std::vector<int>{42});
+    CHECK(st->big.data == std::vector<int>{42});
+}
+
+TEST_CASE("zooming, updating in place, notifies changes")
+{
+    auto st = make_state(big_model{}, automatic_tag{});
+    auto c  = st[&big_model::big].make();
+    auto s  = testing::spy();
+    watch(c, s);
+
+    c.update_inplace([](auto& v) { v.data.push_back(42); });
+    CHECK(c->data == std::vector<int>{42});
+    CHECK(s.count() == 1);
+
+    c.update_inplace([](auto&) {});
+    CHECK(s.count() == 1);
+}
+
+TEST_CASE("zooming, updating in place, many times before commit")
+{
+    auto st = make_state(big_model{});
+    auto c  = st[&big_model::big].make();
+
+    c.update_inplace([](auto& v) { v.data.push_back(1); });
+    c.update_inplace([](auto& v) { v.data.push_back(2); });
+    st[&big_model::small].make().update_inplace([](auto& v) { v = 5; });
+    commit(st);
+    CHECK(st->big.data == (std::vector<int>{1, 2}));
+    CHECK(st->small == 5);
+    CHECK(c->data == (std::vector<int>{1, 2}));
+}
+
+TEST_CASE("out, updating in place rolls back on exceptions")
+{
+    auto st = make_state(std::vector<int>{1, 2});
+    CHECK_THROWS(st.update_inplace([](auto& v) {
+        v.push_back(3);
+        throw std::runtime_error{"boom"};
+    }));
+    commit(st);
+    CHECK(st.get() == (std::vector<int>{1, 2}));
+
+    st.set(std::vector<int>{5});
+    CHECK_THROWS(st.update_inplace([](auto& v) {
+        v.clear();
+        throw std::runtime_error{"boom"};
+    }));
+    commit(st);
+    CHECK(st.get() == (std::vector<int>{5}));
+}
+
+TEST_CASE("zooming, updating in place restores parents on exceptions")
+{
+    auto identity =
+        lenses::getset([](auto&& v) { return LAGER_FWD(v); },
+                       [](auto&&, auto&& x) { return LAGER_FWD(x); });
+    auto failing  = lenses::getset(
+        [](auto&& v) { return LAGER_FWD(v); },
+        [](auto&&, auto&&) -> std::vector<int> {
+            throw std::runtime_error{"boom"};
+        });
+
+    auto st = make_state(std::vector<int>{1, 2});
+    auto a  = st[identity].make();
+    auto b  = a[failing].make();
+    CHECK_THROWS(b.update_inplace([](auto& v) { v.push_back(3); }));
+    CHECK(a.get() == (std::vector<int>{1, 2}));
+
+    commit(st);
+    CHECK(st.get() == (std::vector<int>{1, 2}));
+    CHECK(b.get() == (std::vector<int>{1, 2}));
+}
+
+TEST_CASE("zooming, setting through a filtered parent")
+{
+    auto identity =
+        lenses::getset([](auto&& v) { return LAGER_FWD(v); },
+                       [](auto&&, auto&& x) { return LAGER_FWD(x); });
+    auto st = make_state(std::vector<int>{1, 2});
+    auto x  = st.xform(zug::filter([](auto&& v) { return v.size() != 3; }),
+                      zug::identity)
+                 .make();
+    auto c  = x[identity].make();
+
+    c.set(std::vector<int>{1, 2, 3});
+    CHECK(x.get() == (std::vector<int>{1, 2}));
+
+    commit(st);
+    CHECK(st.get() == (std::vector<int>{1, 2, 3}));
+    CHECK(x.get() == (std::vector<int>{1, 2}));
+}
+
+TEST_CASE("zooming, members are not copied")
+{
+    auto st = make_state(big_model{});
+    auto s  = testing::spy();
+
+    copy_counter::copies = 0;
+    auto c               = st[&big_model::big].make();
+    auto d               = c[&copy_counter::data].make();
+    CHECK(copy_counter::copies == 0);
+
+    watch(c, s);
+    st[&big_model::small].make().set(5);
+    commit(st);
+    CHECK(s.count() == 0);
+
+    d.update_inplace([](auto& v) { v.push_back(42); });
+    commit(st);
+    CHECK(s.count() == 1);
+    CHECK(c->data == std::vector<int>{42});
+    CHECK(d.get() == std::vector<int>{42});
+    CHECK(st->small == 5);
+}
+
+TEST_CASE("zooming, members transform without copies")
+{
+    auto st   = make_state(big_model{}, automatic_tag{});
+    auto size = st[&big_model::big]
+                    .xform(zug::map([](const copy_counter& x) {
+                        return x.data.size();
+                    }))
+                    .make();
+
+    copy_counter::copies = 0;
+    st[&big_model::big][&copy_counter::data].make().set(std::vector<int>{1, 2});
+    CHECK(size.get() == 2);
+    // only the copy of the last value of the state
+    CHECK(copy_counter::copies == 1);
+}
+
 TEST_CASE("values, scoped watching")
 {
     auto st = make_state(0);
@@ -200,3 +411,42 @@ TEST_CASE("automatic_tag edge case")
 
     st.set(vec_t{1, 2, 3, 4}); // this will collect garbage
 }
+
+TEST_CASE("version, changes with the last value")
+{
+    auto st = make_state(big_model{});
+    auto c  = st[&big_model::small].make();
+    auto x  = st.map([](const big_model& m) { return m.small * 2; }).make();
+    auto l  = st.zoom(lenses::attr(&big_model::small)).make();
+    auto w  = with(c, x).make();
+    auto v0 = std::make_tuple(st.version(), c.version(), x.version(),
+                              l.version(), w.version());
+
+    st.set(big_model{{}, 0});
+    commit(st);
+    CHECK(v0 == std::make_tuple(st.version(), c.version(), x.version(),
+                                l.version(), w.version()));
+
+    c.set(5);
+    CHECK(st.version() == std::get<0>(v0));
+    commit(st);
+    CHECK(st.version() > std::get<0>(v0));
+    CHECK(c.version() > std::get<1>(v0));
+    CHECK(x.version() > std::get<2>(v0));
+    CHECK(l.version() > std::get<3>(v0));
+    CHECK(w.version() > std::get<4>(v0));
+}
+
+TEST_CASE("version, unchanged parts keep their version")
+{
+    auto st = make_state(big_model{});
+    auto b  = st[&big_model::big].make();
+    auto s  = st[&big_model::small].make();
+    auto vb = b.version();
+    auto vs = s.version();
+
+    s.set(42);
+    commit(st);
+    CHECK(b.version() == vb);
+    CHECK(s.version() == vs + 1);
+}
@@ -13,10 +13,14 @@
 #include <catch.hpp>
 
 #include <lager/debug/debugger.hpp>
+#include <lager/debug/tree_debugger.hpp>
 #include <lager/event_loop/manual.hpp>
+#include <lager/memory_policy.hpp>
 #include <lager/store.hpp>
 
 #include "../example/counter/counter.hpp"
+#include <chrono>
+#include <iostream>
 #include <optional>
 
 struct dummy_debugger
@@ -79,6 +83,70 @@ TEST_CASE("effect as a result")
     CHECK(called == 1);
 }
 
+TEST_CASE("loop confined memory policy")
+{
+    auto debugger = dummy_debugger{};
+    auto store    = lager::make_store<counter::action>(
+        counter::model{},
+        counter::update,
+        lager::with_manual_event_loop{},
+        lager::with_debugger<lager::debugger, lager::loop_memory_policy>(
+            debugger));
+
+    store.dispatch(counter::increment_action{});
+    store.dispatch(counter::increment_action{});
+    CHECK(store->history.size() == 2);
+    CHECK(store->history.back().model.value == 2);
+}
+
+TEST_CASE("loop confined memory policy, tree debugger")
+{
+    auto debugger = dummy_debugger{};
+    auto store    = lager::make_store<counter::action>(
+        counter::model{},
+        counter::update,
+        lager::with_manual_event_loop{},
+        lager::with_debugger<lager::tree_debugger, lager::loop_memory_policy>(
+            debugger));
+
+    store.dispatch(counter::increment_action{});
+    store.dispatch(counter::increment_action{});
+    CHECK(store->branches.size() == 1);
+    CHECK(store->branches[0].size() == 2);
+    CHECK(store->lookup(store->cursor).second.value == 2);
+}
+
+template <typename MemoryPolicy>
+double record_ms(std::size_t count)
+{
+    auto debugger = dummy_debugger{};
+    auto store    = lager::make_store<counter::action>(
+        counter::model{},
+        counter::update,
+        lager::with_manual_event_loop{},
+        lager::with_debugger<lager::debugger, MemoryPolicy>(debugger));
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (auto i = std::size_t{}; i < count; ++i)
+        store.dispatch(counter::increment_action{});
+    auto t1 = std::chrono::steady_clock::now();
+    CHECK(store->history.size() == count);
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+TEST_CASE("benchmark memory policies", "[.benchmark]")
+{
+    auto count = std::size_t{200000};
+    std::cout << "default_memory_policy: "
+              << record_ms<lager::default_memory_policy>(count) << " ms, "
+              << "unsafe_refcount_memory_policy: "
+              << record_ms<lager::unsafe_refcount_memory_policy>(count)
+              << " ms, "
+              << "loop_memory_policy: "
+              << record_ms<lager::loop_memory_policy>(count) << " ms, "
+              << count << " actions" << std::endl;
+}
+
 namespace services {
 
 struct foo
@@ -111,3 +179,163 @@ TEST_CASE("effect with dependencies")
     store.dispatch(2);
     CHECK(called == 1);
 }
+
+TEST_CASE("search index")
+{
+    using debugger_t =
+        lager::debugger<counter::action, counter::model, lager::deps<>>;
+
+    auto reset_key = [](const counter::action& act) {
+        auto r = std::get_if<counter::reset_action>(&act);
+        return r ? std::optional{std::to_string(r->new_value)} : std::nullopt;
+    };
+    auto debugger = dummy_debugger{};
+    auto store    = lager::make_store<counter::action>(
+        counter::model{},
+        counter::update,
+        lager::with_manual_event_loop{},
+        lager::with_debugger(debugger,
+                             lager::search_key("reset", reset_key)));
+    auto increment =
+        cereal::detail::get_type_name<counter::increment_action>();
+    auto decrement =
+        cereal::detail::get_type_name<counter::decrement_action>();
+
+    store.dispatch(counter::increment_action{});
+    store.dispatch(counter::reset_action{5});
+    store.dispatch(counter::increment_action{});
+    store.dispatch(counter::decrement_action{});
+    store.dispatch(counter::reset_action{5});
+
+    using positions = debugger_t::index_t::positions_t;
+    CHECK(store->index.find_type(increment) == (positions{1, 3}));
+    CHECK(store->index.find_type(decrement) == (positions{4}));
+    CHECK(store->index.find_key("reset", "5") == (positions{2, 5}));
+    CHECK(store->index.find_key("reset", "6").empty());
+    CHECK(store->index.find_key("foo", "5").empty());
+
+    store.dispatch(debugger_t::goto_action{2});
+    store.dispatch(counter::decrement_action{});
+    CHECK(store->index.find_type(increment) == (positions{1}));
+    CHECK(store->index.find_type(decrement) == (positions{3}));
+    CHECK(store->index.find_key("reset", "5") == (positions{2}));
+}
+
+TEST_CASE("search index, pagination")
+{
+    using index_t = lager::search_index<int>;
+
+    auto index = index_t{};
+    for (auto i = 1u; i <= 100; ++i)
+        index = index.add(i * 2, int{});
+
+    auto ps = index.find_type(index_t::type_name(0));
+    CHECK(ps.size() == 100);
+    CHECK(index_t::page(ps, 0, 3) == (std::vector<std::size_t>{2, 4, 6}));
+    CHECK(index_t::page(ps, 51, 2) == (std::vector<std::size_t>{52, 54}));
+    CHECK(index_t::page(ps, 199, 10) == (std::vector<std::size_t>{200}));
+    CHECK(index_t::page(ps, 201, 10).empty());
+}
+
+TEST_CASE("timing")
+{
+    using debugger_t = lager::debugger<int, int, lager::deps<>>;
+
+    auto debugger = dummy_debugger{};
+    auto called   = 0;
+    auto store    = lager::make_store<int>(
+        0,
+        [&](int model, int action) {
+            return std::pair{model + action,
+                             [&](lager::context<int> ctx) { ++called; }};
+        },
+        lager::with_manual_event_loop{},
+        lager::with_debugger(debugger));
+
+    store.dispatch(1);
+    CHECK(!store->lookup_timing(1));
+
+    store.dispatch(debugger_t::timing_action{true});
+    store.dispatch(2);
+    store.dispatch(3);
+    CHECK(called == 3);
+
+    auto timing = store->lookup_timing(2);
+    REQUIRE(timing);
+    CHECK(timing->reducer >= 0);
+    CHECK(timing->propagation >= 0);
+    CHECK(timing->effects >= 0);
+    CHECK(!store->lookup_timing(0));
+
+    auto summary = store->summarize_timing(1);
+    CHECK(summary.enabled);
+    CHECK(summary.steps == 2);
+    CHECK(summary.slowest.size() == 1);
+    CHECK(summary.reducer >= timing->reducer);
+
+    store.dispatch(debugger_t::timing_action{false});
+    store.dispatch(4);
+    CHECK(!store->lookup_timing(4));
+    CHECK(!store->summarize_timing().enabled);
+}
+
+TEST_CASE("only changes to the debugger are notified")
+{
+    using debugger_t = lager::debugger<int, int, lager::deps<>>;
+
+    auto debugger = dummy_debugger{};
+    auto store    = lager::make_store<int>(
+        0,
+        [](int model, int action) { return model + action; },
+        lager::with_manual_event_loop{},
+        lager::with_debugger(debugger));
+    auto notified = 0;
+    watch(store, [&](auto&&) { ++notified; });
+
+    store.dispatch(1);
+    store.dispatch(0);
+    CHECK(notified == 2);
+
+    store.dispatch(debugger_t::goto_action{1});
+    CHECK(notified == 3);
+    store.dispatch(debugger_t::goto_action{1});
+    CHECK(notified == 3);
+
+    store.dispatch(debugger_t::timing_action{true});
+    CHECK(notified == 4);
+    store.dispatch(debugger_t::timing_action{true});
+    CHECK(notified == 4);
+
+    store.dispatch(debugger_t::pause_action{});
+    CHECK(notified == 5);
+    store.dispatch(2);
+    CHECK(notified == 6);
+}
+
+TEST_CASE("only changes to the tree debugger are notified")
+{
+    using debugger_t = lager::tree_debugger<int, int, lager::deps<>>;
+
+    auto debugger = dummy_debugger{};
+    auto store    = lager::make_store<int>(
+        0,
+        [](int model, int action) { return model + action; },
+        lager::with_manual_event_loop{},
+        lager::with_debugger<lager::tree_debugger>(debugger));
+    auto notified = 0;
+    watch(store, [&](auto&&) { ++notified; });
+
+    store.dispatch(1);
+    store.dispatch(0);
+    CHECK(notified == 2);
+
+    store.dispatch(debugger_t::undo_action{});
+    CHECK(notified == 3);
+    store.dispatch(debugger_t::goto_action{store->cursor});
+    CHECK(notified == 3);
+
+    store.dispatch(debugger_t::pause_action{});
+    CHECK(notified == 4);
+    store.dispatch(2);
+    CHECK(notified == 5);
+}
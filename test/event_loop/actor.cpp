@@ -0,0 +1,181 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/event_loop/actor.hpp>
+#include <lager/store.hpp>
+
+#include "../example/counter/counter.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_CASE("basic")
+{
+    auto scheduler = lager::actor_scheduler{2};
+    auto store     = lager::make_store<counter::action>(
+        counter::model{},
+        counter::update,
+        lager::with_actor_event_loop{scheduler});
+
+    store.dispatch(counter::increment_action{});
+    scheduler.wait_idle();
+    CHECK(store->value == 1);
+}
+
+TEST_CASE("many stores from many threads")
+{
+    using store_t = lager::store<counter::action, counter::model>;
+
+    auto scheduler = lager::actor_scheduler{4};
+    auto loops     = std::vector<lager::with_actor_event_loop>{};
+    auto stores    = std::vector<store_t>{};
+    for (auto i = 0; i < 50; ++i) {
+        loops.push_back(lager::with_actor_event_loop{scheduler});
+        stores.push_back(lager::make_store<counter::action>(
+            counter::model{}, counter::update, loops.back()));
+    }
+
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < 8; ++i)
+        threads.push_back(std::thread{[&] {
+            for (auto n = 0; n < 100; ++n)
+                for (auto& s : stores)
+                    s.dispatch(counter::increment_action{});
+        }});
+    for (auto& t : threads)
+        t.join();
+    scheduler.wait_idle();
+
+    for (auto& s : stores)
+        CHECK(s->value == 800);
+    for (auto& l : loops) {
+        auto m = l.metrics();
+        CHECK(m.processed == m.posted);
+        CHECK(m.queued() == 0);
+    }
+}
+
+TEST_CASE("actions of a store are processed serially")
+{
+    auto scheduler = lager::actor_scheduler{4};
+    auto busy      = std::atomic<bool>{false};
+    auto overlaps  = std::atomic<int>{0};
+    auto store     = lager::make_store<int>(
+        0,
+        [&](int model, int action) {
+            if (busy.exchange(true))
+                ++overlaps;
+            std::this_thread::yield();
+            busy = false;
+            return model + action;
+        },
+        lager::with_actor_event_loop{scheduler});
+
+    auto threads = std::vector<std::thread>{};
+    for (auto i = 0; i < 4; ++i)
+        threads.push_back(std::thread{[&] {
+            for (auto n = 0; n < 250; ++n)
+                store.dispatch(1);
+        }});
+    for (auto& t : threads)
+        t.join();
+    scheduler.wait_idle();
+
+    CHECK(overlaps == 0);
+    CHECK(store.get() == 1000);
+}
+
+TEST_CASE("budget bounds the actions processed per turn")
+{
+    auto scheduler = lager::actor_scheduler{1, 10};
+    auto loop      = lager::with_actor_event_loop{scheduler};
+    auto store =
+        lager::make_store<counter::action, lager::transactional_tag>(
+            counter::model{}, counter::update, loop);
+
+    loop.pause();
+    for (auto i = 0; i < 100; ++i)
+        store.dispatch(counter::increment_action{});
+    CHECK(loop.metrics().queued() == 100);
+
+    loop.resume();
+    scheduler.wait_idle();
+    CHECK(loop.metrics().turns == 10);
+    lager::commit(store);
+    CHECK(store->value == 100);
+}
+
+TEST_CASE("pause and resume")
+{
+    auto scheduler = lager::actor_scheduler{2};
+    auto loop      = lager::with_actor_event_loop{scheduler};
+    auto store     = lager::make_store<counter::action>(
+        counter::model{}, counter::update, loop);
+
+    loop.pause();
+    store.dispatch(counter::increment_action{});
+    store.dispatch(counter::increment_action{});
+    scheduler.wait_idle();
+    CHECK(store->value == 0);
+
+    loop.resume();
+    scheduler.wait_idle();
+    CHECK(store->value == 2);
+}
+
+TEST_CASE("stress, all events are processed")
+{
+    for (auto round = 0; round < 50; ++round) {
+        auto scheduler = lager::actor_scheduler{4, 1};
+        auto loops     = std::vector<lager::with_actor_event_loop>{};
+        auto counts    = std::vector<int>(8, 0);
+        for (auto i = 0; i < 8; ++i)
+            loops.push_back(lager::with_actor_event_loop{scheduler});
+
+        auto threads = std::vector<std::thread>{};
+        for (auto i = 0; i < 4; ++i)
+            threads.push_back(std::thread{[&] {
+                for (auto n = 0; n < 400; ++n)
+                    for (auto j = 0u; j < loops.size(); ++j)
+                        loops[j].post([&counts, j] { ++counts[j]; });
+            }});
+        for (auto& t : threads)
+            t.join();
+        scheduler.wait_idle();
+
+        for (auto i = 0u; i < loops.size(); ++i) {
+            CHECK(counts[i] == 1600);
+            CHECK(loops[i].metrics().queued() == 0);
+        }
+    }
+}
+
+TEST_CASE("exceptions are rethrown when waiting")
+{
+    auto scheduler = lager::actor_scheduler{2};
+    auto loop      = lager::with_actor_event_loop{scheduler};
+    auto count     = 0;
+
+    loop.post([] { throw std::runtime_error{"boom"}; });
+    loop.post([&] { ++count; });
+    CHECK_THROWS_AS(scheduler.wait_idle(), std::runtime_error const&);
+    CHECK(count == 1);
+    CHECK(loop.metrics().queued() == 0);
+
+    loop.post([&] { ++count; });
+    scheduler.wait_idle();
+    CHECK(count == 2);
+}
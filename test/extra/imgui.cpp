@@ -0,0 +1,49 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/extra/imgui.hpp>
+
+#include <string>
+
+TEST_CASE("frame_cache, makes values only once")
+{
+    auto cache = lager::frame_cache<int, std::string>{};
+    auto made  = 0;
+    auto make  = [&] {
+        ++made;
+        return std::string{"foo"};
+    };
+
+    CHECK(cache.get(1, make) == "foo");
+    CHECK(cache.get(1, make) == "foo");
+    cache.collect();
+    CHECK(cache.get(1, make) == "foo");
+    CHECK(made == 1);
+    CHECK(cache.size() == 1);
+}
+
+TEST_CASE("frame_cache, evicts values not used during a frame")
+{
+    auto cache = lager::frame_cache<int, int>{};
+    cache.get(1, [] { return 1; });
+    cache.get(2, [] { return 2; });
+    cache.collect();
+    CHECK(cache.size() == 2);
+
+    cache.get(2, [] { return 0; });
+    cache.collect();
+    CHECK(cache.size() == 1);
+    CHECK(cache.get(2, [] { return 0; }) == 2);
+    CHECK(cache.get(1, [] { return 0; }) == 0);
+}
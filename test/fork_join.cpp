@@ -0,0 +1,156 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/event_loop/manual.hpp>
+#include <lager/fork_join.hpp>
+#include <lager/lenses/attr.hpp>
+#include <lager/store.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct model
+{
+    int a = 0;
+    int b = 0;
+    int c = 0;
+
+    bool operator==(const model& x) const
+    {
+        return a == x.a && b == x.b && c == x.c;
+    }
+    bool operator!=(const model& x) const { return !(*this == x); }
+};
+
+auto add = [](int x, int action) { return x + action; };
+
+auto inline_executor = [](auto fn) { fn(); };
+
+struct thread_executor
+{
+    std::vector<std::thread>* threads;
+
+    void operator()(std::function<void()> fn) const
+    {
+        threads->emplace_back(std::move(fn));
+    }
+};
+
+struct threads_t : std::vector<std::thread>
+{
+    ~threads_t()
+    {
+        for (auto& t : *this)
+            t.join();
+    }
+};
+
+} // namespace
+
+using lager::lenses::attr;
+
+TEST_CASE("fork_join, updates every slice")
+{
+    auto reducer = lager::fork_join(inline_executor,
+                                    lager::slice(attr(&model::a), add),
+                                    lager::slice(attr(&model::c), add));
+    auto m       = reducer(model{1, 2, 3}, 10);
+    CHECK(m == (model{11, 2, 13}));
+}
+
+TEST_CASE("fork_join, runs slices concurrently")
+{
+    auto threads    = threads_t{};
+    auto first      = std::atomic<bool>{false};
+    auto seen       = std::atomic<bool>{false};
+    auto wait_first = [&](int x, int) {
+        using namespace std::chrono_literals;
+        auto deadline = std::chrono::steady_clock::now() + 5s;
+        while (!first && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+        seen = first.load();
+        return x + 1;
+    };
+    auto reducer = lager::fork_join(
+        thread_executor{&threads},
+        lager::slice(attr(&model::a),
+                     [&](int x, int) {
+                         first = true;
+                         return x + 1;
+                     }),
+        lager::slice(attr(&model::b), wait_first),
+        lager::slice(attr(&model::c), wait_first));
+    auto m = reducer(model{}, 0);
+    CHECK(m == (model{1, 1, 1}));
+    CHECK(seen);
+}
+
+TEST_CASE("fork_join, effects run in order")
+{
+    auto threads     = threads_t{};
+    auto log         = std::vector<int>{};
+    auto with_effect = [&](int n) {
+        return [&log, n](int x, int action) {
+            auto eff = [&log, n](auto&&) { log.push_back(n); };
+            return std::pair{x + action, eff};
+        };
+    };
+    auto reducer = lager::fork_join(
+        thread_executor{&threads},
+        lager::slice(attr(&model::a), with_effect(1)),
+        lager::slice(attr(&model::b), add),
+        lager::slice(attr(&model::c), with_effect(3)));
+    auto [m, eff] = reducer(model{}, 2);
+    CHECK(m == (model{2, 2, 2}));
+    CHECK(log.empty());
+    eff(0);
+    CHECK(log == (std::vector<int>{1, 3}));
+}
+
+TEST_CASE("fork_join, rethrows errors of the slices")
+{
+    auto threads = threads_t{};
+    auto fail    = [](int, int) -> int { throw std::runtime_error{"slice"}; };
+    auto reducer = lager::fork_join(thread_executor{&threads},
+                                    lager::slice(attr(&model::a), add),
+                                    lager::slice(attr(&model::b), fail));
+    CHECK_THROWS_AS(reducer(model{}, 1), std::runtime_error const&);
+}
+
+TEST_CASE("fork_join, in a store")
+{
+    auto threads = threads_t{};
+    auto called  = 0;
+    auto store   = lager::make_store<int>(
+        model{},
+        lager::fork_join(
+            thread_executor{&threads},
+            lager::slice(attr(&model::a), add),
+            lager::slice(attr(&model::b),
+                         [&](int x, int action) {
+                             auto eff = lager::effect<int>{
+                                 [&](auto&&) { ++called; }};
+                             return std::pair{x - action, eff};
+                         })),
+        lager::with_manual_event_loop{});
+
+    store.dispatch(5);
+    CHECK(store.get() == (model{5, -5, 0}));
+    CHECK(called == 1);
+}
@@ -0,0 +1,40 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/debug/debugger.hpp>
+#include <lager/debug/http_server.hpp>
+#include <lager/debug/tree_debugger.hpp>
+
+#include "../example/counter/counter.hpp"
+
+using debugger_t =
+    lager::debugger<counter::action, counter::model, lager::deps<>>;
+using tree_debugger_t =
+    lager::tree_debugger<counter::action, counter::model, lager::deps<>>;
+
+// Instantiates all the resources of the server, including the virtual ones
+// that are not registered for the debugger.
+template struct lager::http_debug_server::handle<debugger_t>;
+template struct lager::http_debug_server::handle<tree_debugger_t>;
+
+TEST_CASE("http server, features of the debuggers")
+{
+    using handle_t      = lager::http_debug_server::handle<debugger_t>;
+    using tree_handle_t = lager::http_debug_server::handle<tree_debugger_t>;
+
+    CHECK(handle_t::has_search);
+    CHECK(handle_t::has_timing);
+    CHECK(!tree_handle_t::has_search);
+    CHECK(!tree_handle_t::has_timing);
+}
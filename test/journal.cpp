@@ -0,0 +1,143 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/event_loop/manual.hpp>
+#include <lager/journal.hpp>
+#include <lager/store.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::string temp_journal_path(const std::string& name)
+{
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+auto encode = [](int action) { return std::to_string(action); };
+
+} // namespace
+
+TEST_CASE("journal, records are read back in order")
+{
+    auto path = temp_journal_path("lager-journal-order.log");
+    {
+        auto j = lager::journal{path};
+        CHECK(j.append("foo") == 1);
+        CHECK(j.append("") == 2);
+        CHECK(j.append(std::string(1000, 'x')) == 3);
+        j.wait_durable();
+        CHECK(j.last_durable() == 3);
+    }
+    auto records = lager::read_journal(path);
+    CHECK(records ==
+          (std::vector<std::string>{"foo", "", std::string(1000, 'x')}));
+}
+
+TEST_CASE("journal, pending records are written on destruction")
+{
+    auto path = temp_journal_path("lager-journal-close.log");
+    {
+        auto opts        = lager::journal_options{};
+        opts.group_size  = 1000;
+        opts.group_delay = std::chrono::seconds{10};
+        auto j           = lager::journal{path, opts};
+        j.append("a");
+        j.append("b");
+    }
+    CHECK(lager::read_journal(path) == (std::vector<std::string>{"a", "b"}));
+}
+
+TEST_CASE("journal, durability callbacks")
+{
+    // declared before the journal, which may call back until destroyed
+    auto acked = std::atomic<int>{0};
+    auto path  = temp_journal_path("lager-journal-callbacks.log");
+    auto j     = lager::journal{path};
+    auto seq   = j.append("a");
+    j.on_durable(seq, [&] { ++acked; });
+    // callbacks run after the record is durable, so wait for the call
+    while (acked == 0)
+        std::this_thread::yield();
+    j.on_durable(seq, [&] { ++acked; });
+    CHECK(acked == 2);
+}
+
+#if defined(__linux__)
+TEST_CASE("journal, write errors")
+{
+    auto acked = std::atomic<int>{0};
+    auto j     = lager::journal{"/dev/full"};
+    auto seq   = j.append("a");
+    j.on_durable(seq, [&] { ++acked; });
+    CHECK_THROWS_AS(j.wait_durable(seq), lager::journal_error const&);
+    CHECK_THROWS_AS(j.on_durable(seq, [&] { ++acked; }),
+                    lager::journal_error const&);
+    CHECK_THROWS_AS(j.append("b"), lager::journal_error const&);
+    CHECK(acked == 0);
+}
+#endif
+
+TEST_CASE("journal, store enhancer")
+{
+    auto path = temp_journal_path("lager-journal-store.log");
+    auto acks = std::atomic<int>{0};
+    {
+        auto j       = lager::journal{path};
+        auto reducer = [&](int model, int action) {
+            using deps_t = lager::deps<lager::journal&>;
+            auto eff     = lager::effect<int, deps_t>{[&](auto&& ctx) {
+                lager::get<lager::journal>(ctx).on_durable([&] { ++acks; });
+            }};
+            return std::pair{model + action, eff};
+        };
+        auto store = lager::make_store<int>(0,
+                                            reducer,
+                                            lager::with_manual_event_loop{},
+                                            lager::with_journal(j, encode));
+        store.dispatch(1);
+        store.dispatch(2);
+        store.dispatch(3);
+        CHECK(store.get() == 6);
+        j.wait_durable();
+    }
+    CHECK(acks == 3);
+    CHECK(lager::read_journal(path) ==
+          (std::vector<std::string>{"1", "2", "3"}));
+}
+
+TEST_CASE("journal, synchronous durability")
+{
+    auto path       = temp_journal_path("lager-journal-sync.log");
+    auto opts       = lager::journal_options{};
+    opts.durability = lager::journal_durability::sync;
+    auto j          = lager::journal{path, opts};
+    auto store      = lager::make_store<int>(
+        0,
+        [&](int model, int action) {
+            CHECK(j.last_durable() == j.last_appended());
+            return model + action;
+        },
+        lager::with_manual_event_loop{},
+        lager::with_journal(j, encode));
+    store.dispatch(1);
+    store.dispatch(2);
+    CHECK(j.last_durable() == 2);
+}
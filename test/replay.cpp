@@ -0,0 +1,123 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/replay.hpp>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+using checkpoints_t = std::vector<lager::replay_checkpoint<int>>;
+
+auto add = [](int m, int a) { return m + a; };
+
+std::vector<int> make_actions(std::size_t n)
+{
+    auto r = std::vector<int>(n);
+    std::iota(r.begin(), r.end(), 1);
+    return r;
+}
+
+checkpoints_t make_checkpoints(const std::vector<int>& actions,
+                               std::size_t every)
+{
+    auto r = checkpoints_t{};
+    auto m = 0;
+    for (auto i = std::size_t{}; i <= actions.size(); ++i) {
+        if (i % every == 0)
+            r.push_back({i, m});
+        if (i < actions.size())
+            m = add(m, actions[i]);
+    }
+    return r;
+}
+
+} // namespace
+
+TEST_CASE("replay, verifies every segment")
+{
+    auto actions     = make_actions(1000);
+    auto checkpoints = make_checkpoints(actions, 100);
+    auto result      = lager::replay_verify(add, actions, checkpoints, 4);
+    CHECK(result.ok());
+    CHECK(result.model == 500500);
+}
+
+TEST_CASE("replay, detects mismatches")
+{
+    auto actions     = make_actions(1000);
+    auto checkpoints = make_checkpoints(actions, 100);
+    checkpoints[3].model += 1;
+    auto result = lager::replay_verify(add, actions, checkpoints, 4);
+    REQUIRE(result.mismatches.size() == 2);
+    CHECK(result.mismatches[0].segment == 2);
+    CHECK(result.mismatches[0].step == 300);
+    CHECK(result.mismatches[0].expected == result.mismatches[0].actual + 1);
+    CHECK(result.mismatches[1].segment == 3);
+    CHECK(result.model == 500500);
+}
+
+TEST_CASE("replay, detects non-determinism")
+{
+    auto calls   = std::atomic<int>{0};
+    auto flaky   = [&](int m, int a) { return m + a + (++calls == 50); };
+    auto actions = make_actions(100);
+    auto result  = lager::replay_verify(
+        flaky, actions, make_checkpoints(actions, 10), 1);
+    CHECK(result.mismatches.size() == 1);
+}
+
+TEST_CASE("replay, seeks to a step")
+{
+    auto actions     = make_actions(1000);
+    auto checkpoints = make_checkpoints(actions, 100);
+    auto calls       = 0;
+    auto counting    = [&](int m, int a) {
+        ++calls;
+        return m + a;
+    };
+    CHECK(lager::replay_to(counting, actions, checkpoints, 0) == 0);
+    CHECK(lager::replay_to(counting, actions, checkpoints, 250) == 31375);
+    CHECK(calls == 50);
+    CHECK(lager::replay_to(counting, actions, checkpoints, 1000) == 500500);
+    CHECK(calls == 50);
+    CHECK_THROWS_AS(lager::replay_to(counting, actions, checkpoints, 1001),
+                    std::out_of_range const&);
+}
+
+TEST_CASE("replay, reducers with effects")
+{
+    auto reducer = [](int m, int a) {
+        return std::pair{m + a, lager::effect<int>{[](auto&&) {}}};
+    };
+    auto actions = make_actions(10);
+    auto result  = lager::replay_verify(
+        reducer, actions, make_checkpoints(actions, 3));
+    CHECK(result.ok());
+    CHECK(result.model == 55);
+}
+
+TEST_CASE("replay, invalid checkpoints")
+{
+    auto actions = make_actions(10);
+    CHECK_THROWS_AS(lager::replay_verify(add, actions, checkpoints_t{}),
+                    std::invalid_argument const&);
+    CHECK_THROWS_AS(
+        lager::replay_verify(add, actions, checkpoints_t{{5, 0}, {2, 0}}),
+        std::invalid_argument const&);
+}
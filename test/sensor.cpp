@@ -60,3 +60,16 @@ TEST_CASE("sensor, watching")
     commit(x);
     CHECK(2 == s.count());
 }
+
+TEST_CASE("sensor, version")
+{
+    auto x = make_sensor(counter{});
+    auto v = x.version();
+    commit(x);
+    CHECK(x.version() == v + 1);
+
+    auto y = make_sensor([] { return 42; });
+    auto w = y.version();
+    commit(y);
+    CHECK(y.version() == w);
+}
@@ -0,0 +1,74 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/slice_reader.hpp>
+#include <lager/state.hpp>
+
+#include <immer/flex_vector.hpp>
+
+#include "spies.hpp"
+
+using namespace lager;
+
+using vec_t = immer::flex_vector<int>;
+
+TEST_CASE("slice_reader, fixed bounds")
+{
+    auto st = make_state(vec_t{0, 1, 2, 3, 4, 5});
+    auto sl = slice_reader(st, 1, 4);
+    CHECK(sl.get() == (vec_t{1, 2, 3}));
+
+    st.set(vec_t{10, 11, 12, 13, 14});
+    commit(st);
+    CHECK(sl.get() == (vec_t{11, 12, 13}));
+}
+
+TEST_CASE("slice_reader, clamps the bounds")
+{
+    auto st = make_state(vec_t{0, 1, 2});
+    CHECK(slice_reader(st, 1, 10).get() == (vec_t{1, 2}));
+    CHECK(slice_reader(st, 5, 10).get() == vec_t{});
+    CHECK(slice_reader(st, 2, 1).get() == vec_t{});
+    CHECK(slice_reader(st, 0, 3).get() == (vec_t{0, 1, 2}));
+}
+
+TEST_CASE("slice_reader, follows the bounds")
+{
+    auto st    = make_state(vec_t{0, 1, 2, 3, 4, 5});
+    auto begin = make_state(std::size_t{0});
+    auto end   = begin.map([](auto x) { return x + 2; });
+    auto sl    = slice_reader(st, begin, end);
+    CHECK(sl.get() == (vec_t{0, 1}));
+
+    begin.set(3);
+    commit(begin);
+    CHECK(sl.get() == (vec_t{3, 4}));
+}
+
+TEST_CASE("slice_reader, notifies only when the window changes")
+{
+    auto st = make_state(vec_t{0, 1, 2, 3, 4, 5});
+    auto sl = slice_reader(st, 0, 2);
+    auto s  = testing::spy();
+    watch(sl, s);
+
+    st.set(st.get().set(4, 42));
+    commit(st);
+    CHECK(s.count() == 0);
+
+    st.set(st.get().set(1, 42));
+    commit(st);
+    CHECK(s.count() == 1);
+    CHECK(sl.get() == (vec_t{0, 42}));
+}
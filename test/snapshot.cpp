@@ -0,0 +1,105 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/event_loop/manual.hpp>
+#include <lager/snapshot.hpp>
+#include <lager/store.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("snapshot, saves in the background")
+{
+    auto saved = std::vector<int>{};
+    {
+        auto s = lager::snapshotter<int>{[&](int x) { saved.push_back(x); }};
+        s.request(1);
+        s.flush();
+        s.request(2);
+        s.flush();
+        CHECK(s.saved_count() == 2);
+    }
+    CHECK(saved == (std::vector<int>{1, 2}));
+}
+
+TEST_CASE("snapshot, latest snapshot wins")
+{
+    auto mutex   = std::mutex{};
+    auto cv      = std::condition_variable{};
+    auto blocked = true;
+    auto saved   = std::vector<int>{};
+    {
+        auto s = lager::snapshotter<int>{[&](int x) {
+            auto lock = std::unique_lock<std::mutex>{mutex};
+            cv.wait(lock, [&] { return !blocked; });
+            saved.push_back(x);
+        }};
+        s.request(1);
+        // the first snapshot may or may not be in progress, but the next ones
+        // are queued while it is blocked
+        s.request(2);
+        s.request(3);
+        {
+            auto lock = std::unique_lock<std::mutex>{mutex};
+            blocked   = false;
+        }
+        cv.notify_all();
+        s.flush();
+    }
+    REQUIRE(!saved.empty());
+    CHECK(saved.size() <= 2);
+    CHECK(saved.back() == 3);
+}
+
+TEST_CASE("snapshot, rate limiting")
+{
+    auto saved = std::vector<int>{};
+    {
+        auto s = lager::snapshotter<int>{[&](int x) { saved.push_back(x); },
+                                         std::chrono::hours{1}};
+        s.request(1);
+        s.flush();
+        s.request(2);
+        s.request(3);
+        CHECK(s.saved_count() == 1);
+    }
+    // pending snapshots are saved on destruction
+    CHECK(saved == (std::vector<int>{1, 3}));
+}
+
+TEST_CASE("snapshot, errors are reported")
+{
+    auto s = lager::snapshotter<int>{
+        [](int) { throw std::runtime_error{"noo"}; }};
+    s.request(1);
+    CHECK_THROWS_AS(s.flush(), std::runtime_error const&);
+    s.request(2);
+}
+
+TEST_CASE("snapshot, watching a store")
+{
+    auto saved = std::vector<int>{};
+    auto s     = lager::snapshotter<int>{[&](int x) { saved.push_back(x); }};
+    auto store = lager::make_store<int>(
+        0, [](int m, int a) { return m + a; }, lager::with_manual_event_loop{});
+    watch(store, [&](int m) { s.request(m); });
+    store.dispatch(1);
+    s.flush();
+    store.dispatch(2);
+    s.flush();
+    CHECK(saved == (std::vector<int>{1, 3}));
+}
@@ -0,0 +1,127 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/lenses.hpp>
+#include <lager/lenses/at.hpp>
+#include <lager/lenses/column.hpp>
+#include <lager/soa.hpp>
+#include <lager/state.hpp>
+
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+struct particle
+{
+    float x  = 0;
+    float v  = 0;
+    int hits = 0;
+
+    bool operator==(const particle& p) const
+    {
+        return x == p.x && v == p.v && hits == p.hits;
+    }
+    bool operator!=(const particle& p) const { return !(*this == p); }
+};
+
+using particles =
+    lager::soa<particle, &particle::x, &particle::v, &particle::hits>;
+
+} // namespace
+
+TEST_CASE("soa, basic")
+{
+    auto ps = particles{{1, 2, 0}, {3, 4, 0}};
+    CHECK(ps.size() == 2);
+    CHECK(ps[1] == (particle{3, 4, 0}));
+    CHECK(ps.column<&particle::v>()[0] == 2);
+    CHECK_THROWS_AS(ps.at(2), std::out_of_range const&);
+
+    auto qs = ps.push_back({5, 6, 1});
+    CHECK(ps.size() == 2);
+    CHECK(qs.size() == 3);
+    CHECK(qs[2] == (particle{5, 6, 1}));
+
+    auto rs = qs.set(0, {0, 0, 7});
+    CHECK(qs[0] == (particle{1, 2, 0}));
+    CHECK(rs[0] == (particle{0, 0, 7}));
+    CHECK(rs != qs);
+    CHECK(rs == rs.set(1, rs[1]));
+}
+
+TEST_CASE("soa, bulk update")
+{
+    auto ps = particles{{1, 2, 0}, {3, 4, 0}, {5, 6, 0}};
+    auto qs = ps.update<&particle::x, &particle::v>(
+        [](float x, float v) { return x + v * 0.5f; });
+    CHECK(ps[0].x == 1);
+    CHECK(qs[0].x == 2);
+    CHECK(qs[1].x == 5);
+    CHECK(qs[2].x == 8);
+    CHECK(qs.column<&particle::v>() == ps.column<&particle::v>());
+
+    auto incr = [](int h) { return h + 1; };
+    auto rs   = std::move(qs).update<&particle::hits>(incr);
+    CHECK(rs[2] == (particle{8, 6, 1}));
+}
+
+TEST_CASE("soa, updating temporaries returns values")
+{
+    static_assert(
+        std::is_same_v<decltype(particles{}.push_back({})), particles>);
+
+    // would dangle if a reference to the temporary was returned
+    auto&& ps = particles{{1, 2, 0}}.push_back({3, 4, 0}).set(0, {5, 6, 0});
+    CHECK(ps.size() == 2);
+    CHECK(ps[0] == (particle{5, 6, 0}));
+    CHECK(ps[1] == (particle{3, 4, 0}));
+}
+
+TEST_CASE("soa, updating a column with itself as input")
+{
+    auto ps = particles{{1, 0, 0}, {2, 0, 0}};
+    auto qs = std::move(ps).update<&particle::x, &particle::x>(
+        [](float x, float y) { return x + y; });
+    CHECK(qs[0].x == 2);
+    CHECK(qs[1].x == 4);
+}
+
+TEST_CASE("soa, lenses")
+{
+    auto ps = particles{{1, 2, 0}, {3, 4, 0}};
+    auto xs = lager::lenses::column<&particle::x>();
+    CHECK(lager::view(xs, ps)[1] == 3);
+
+    auto qs = lager::set(xs, ps, immer::array<float>{7, 8});
+    CHECK(qs[0] == (particle{7, 2, 0}));
+    CHECK(qs[1] == (particle{8, 4, 0}));
+
+    auto second = lager::lenses::at(1);
+    CHECK(lager::view(second, ps) == (particle{3, 4, 0}));
+    auto rs = lager::set(second, ps, particle{0, 0, 1});
+    CHECK(rs[1] == (particle{0, 0, 1}));
+}
+
+TEST_CASE("soa, cursors")
+{
+    auto st = lager::make_state(particles{{1, 2, 0}, {3, 4, 0}});
+    auto p  = st[1].make();
+    auto xs = st.zoom(lager::lenses::column<&particle::x>()).make();
+
+    p.set(particle{5, 6, 0});
+    lager::commit(st);
+    CHECK(xs.get()[1] == 5);
+    CHECK(st->column<&particle::v>()[1] == 6);
+}
@@ -183,3 +183,62 @@ TEST_CASE("state, capsule carries its own watchers")
     CHECK(1 == s.count());
     CHECK(sig->observers().empty());
 }
+
+TEST_CASE("state, deferred propagates right away")
+{
+    auto st = make_state(0, deferred_tag{});
+    auto s  = testing::spy();
+    watch(st, s);
+    st.set(42);
+    CHECK(st.get() == 42);
+    CHECK(s.count() == 1);
+}
+
+TEST_CASE("state, deferred combines sets during notification")
+{
+    auto x  = make_state(0, deferred_tag{});
+    auto y  = make_state(0, deferred_tag{});
+    auto sy = testing::spy([&](int curr) { CHECK(curr == 2); });
+    watch(x, [&](int) {
+        y.set(1);
+        CHECK(y.get() == 0);
+        y.set(2);
+        CHECK(y.get() == 0);
+    });
+    watch(y, sy);
+
+    x.set(42);
+    CHECK(y.get() == 2);
+    CHECK(sy.count() == 1);
+}
+
+TEST_CASE("state, deferred sets to itself during notification")
+{
+    auto st     = make_state(0, deferred_tag{});
+    auto values = std::vector<int>{};
+    watch(st, [&](int curr) {
+        values.push_back(curr);
+        if (curr > 10)
+            st.set(10);
+    });
+    st.set(42);
+    CHECK(st.get() == 10);
+    CHECK(values == (std::vector<int>{42, 10}));
+}
+
+TEST_CASE("state, deferred derived nodes see combined changes")
+{
+    auto x   = make_state(0, deferred_tag{});
+    auto y   = make_state(0, deferred_tag{});
+    auto z   = make_state(0, deferred_tag{});
+    auto sum = with(y, z).map([](int a, int b) { return a + b; }).make();
+    auto s   = testing::spy([&](int curr) { CHECK(curr == 10); });
+    watch(sum, s);
+    watch(x, [&](int v) {
+        y.set(v);
+        z.set(v);
+    });
+    x.set(5);
+    CHECK(sum.get() == 10);
+    CHECK(s.count() == 1);
+}
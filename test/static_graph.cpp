@@ -0,0 +1,128 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/reader.hpp>
+#include <lager/state.hpp>
+#include <lager/static_graph.hpp>
+
+#include <string>
+
+#include "spies.hpp"
+
+using namespace lager;
+
+namespace {
+
+struct player
+{
+    int health = 0;
+    int ammo   = 0;
+
+    bool operator==(const player& x) const
+    {
+        return health == x.health && ammo == x.ammo;
+    }
+    bool operator!=(const player& x) const { return !(*this == x); }
+};
+
+struct model
+{
+    player hero;
+    int time = 0;
+
+    bool operator==(const model& x) const
+    {
+        return hero == x.hero && time == x.time;
+    }
+    bool operator!=(const model& x) const { return !(*this == x); }
+};
+
+} // namespace
+
+TEST_CASE("static graph, maps and zooms")
+{
+    auto st  = make_state(model{{10, 3}, 0});
+    auto hud = make_static(st, [](auto game) {
+        auto hero = game[&model::hero];
+        return static_with(hero[&player::health], hero[&player::ammo])
+            .map([](int health, int ammo) {
+                return std::to_string(health) + "/" + std::to_string(ammo);
+            });
+    });
+    CHECK(hud.get() == "10/3");
+
+    st.set(model{{9, 3}, 0});
+    commit(st);
+    CHECK(hud.get() == "9/3");
+}
+
+TEST_CASE("static graph, skips stages whose inputs did not change")
+{
+    auto st    = make_state(model{{10, 3}, 0});
+    auto calls = 0;
+    auto hud   = make_static(st, [&](auto game) {
+        return game[&model::hero].map([&](const player& p) {
+            ++calls;
+            return p.health * 2;
+        });
+    });
+    auto s = testing::spy();
+    watch(hud, s);
+    CHECK(hud.get() == 20);
+    CHECK(calls == 1);
+
+    st.set(model{{10, 3}, 1});
+    commit(st);
+    CHECK(calls == 1);
+    CHECK(s.count() == 0);
+
+    st.set(model{{10, 4}, 1});
+    commit(st);
+    CHECK(calls == 2);
+    CHECK(s.count() == 0);
+
+    st.set(model{{11, 4}, 1});
+    commit(st);
+    CHECK(calls == 3);
+    CHECK(s.count() == 1);
+    CHECK(hud.get() == 22);
+}
+
+TEST_CASE("static graph, prebuilt expressions and filters")
+{
+    auto st   = make_state(0);
+    auto even = static_source<int>{}.filter([](int x) { return x % 2 == 0; });
+    auto r    = make_static(st, even.map([](int x) { return x * 10; }));
+    CHECK(r.get() == 0);
+
+    st.set(3);
+    commit(st);
+    CHECK(r.get() == 0);
+
+    st.set(4);
+    commit(st);
+    CHECK(r.get() == 40);
+}
+
+TEST_CASE("static graph, results are ordinary readers")
+{
+    auto st = make_state(model{{10, 3}, 0});
+    reader<int> health = make_static(st, [](auto game) {
+        return game[&model::hero].zoom(lenses::attr(&player::health));
+    });
+    auto twice = health.map([](int x) { return x * 2; }).make();
+    st.set(model{{5, 3}, 0});
+    commit(st);
+    CHECK(twice.get() == 10);
+}
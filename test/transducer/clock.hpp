@@ -0,0 +1,34 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#pragma once
+
+#include <chrono>
+
+/*!
+ * Clock that only advances when told to, for testing time based
+ * transducers.
+ */
+struct fake_clock
+{
+    using duration   = std::chrono::milliseconds;
+    using rep        = duration::rep;
+    using period     = duration::period;
+    using time_point = std::chrono::time_point<fake_clock>;
+
+    static constexpr bool is_steady = true;
+
+    static time_point now() { return current; }
+    static void advance(duration d) { current += d; }
+
+    static inline time_point current = {};
+};
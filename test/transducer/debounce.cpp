@@ -0,0 +1,110 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include "clock.hpp"
+
+#include <lager/cursor.hpp>
+#include <lager/lenses.hpp>
+#include <lager/state.hpp>
+#include <lager/transducer/debounce.hpp>
+#include <lager/with.hpp>
+
+using namespace lager;
+using namespace std::chrono_literals;
+
+TEST_CASE("debounce, lets the initial value through")
+{
+    auto s = state<int>{42};
+    auto x = s.xform(debounce<fake_clock>(10ms)).make();
+    CHECK(x.get() == 42);
+}
+
+TEST_CASE("debounce, drops bursts of values")
+{
+    auto s = state<int>{0};
+    auto x = s.xform(debounce<fake_clock>(10ms)).make();
+
+    for (auto i = 1; i < 5; ++i) {
+        fake_clock::advance(5ms);
+        s.set(i);
+        commit(s);
+        CHECK(x.get() == 0);
+    }
+
+    fake_clock::advance(10ms);
+    s.set(5);
+    commit(s);
+    CHECK(x.get() == 5);
+}
+
+TEST_CASE("debounce, delivers the last value of a burst on a tick")
+{
+    auto s    = state<int>{0};
+    auto tick = state<fake_clock::time_point>{fake_clock::now()};
+    auto x    = with(s, tick).xform(debounce<fake_clock>(10ms)).make();
+    CHECK(x.get() == 0);
+
+    for (auto i = 1; i < 5; ++i) {
+        fake_clock::advance(5ms);
+        s.set(i);
+        commit(s);
+        CHECK(x.get() == 0);
+    }
+
+    fake_clock::advance(5ms);
+    tick.set(fake_clock::now());
+    commit(tick);
+    CHECK(x.get() == 0);
+
+    fake_clock::advance(5ms);
+    tick.set(fake_clock::now());
+    commit(tick);
+    CHECK(x.get() == 4);
+}
+
+TEST_CASE("debounce, ticks do not restart the interval")
+{
+    auto s    = state<int>{0};
+    auto tick = state<fake_clock::time_point>{fake_clock::now()};
+    auto x    = with(s, tick).xform(debounce<fake_clock>(10ms)).make();
+
+    fake_clock::advance(10ms);
+    s.set(1);
+    commit(s);
+    CHECK(x.get() == 1);
+
+    for (auto i = 0; i < 3; ++i) {
+        fake_clock::advance(4ms);
+        tick.set(fake_clock::now());
+        commit(tick);
+    }
+    s.set(2);
+    commit(s);
+    CHECK(x.get() == 2);
+}
+
+TEST_CASE("debounce, measures time once per change when written through")
+{
+    auto identity =
+        lenses::getset([](auto&& v) { return LAGER_FWD(v); },
+                       [](auto&&, auto&& x) { return LAGER_FWD(x); });
+    auto s = state<int>{0};
+    auto x = s.xform(debounce<fake_clock>(10ms), zug::identity).make();
+    auto c = x[identity].make();
+
+    fake_clock::advance(10ms);
+    c.set(1);
+    commit(s);
+    CHECK(x.get() == 1);
+}
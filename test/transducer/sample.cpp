@@ -0,0 +1,99 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include "clock.hpp"
+
+#include <lager/cursor.hpp>
+#include <lager/lenses.hpp>
+#include <lager/state.hpp>
+#include <lager/transducer/sample.hpp>
+#include <lager/with.hpp>
+
+#include <zug/transducer/map.hpp>
+
+using namespace lager;
+using namespace std::chrono_literals;
+
+TEST_CASE("sample, lets the initial value through")
+{
+    auto s = state<int>{42};
+    auto x = s.xform(sample<fake_clock>(10ms)).make();
+    CHECK(x.get() == 42);
+}
+
+TEST_CASE("sample, drops values within the interval")
+{
+    auto s = state<int>{0};
+    auto x = s.xform(sample<fake_clock>(10ms)).make();
+
+    fake_clock::advance(10ms);
+    s.set(1);
+    commit(s);
+    CHECK(x.get() == 1);
+
+    fake_clock::advance(5ms);
+    s.set(2);
+    commit(s);
+    CHECK(x.get() == 1);
+
+    fake_clock::advance(4ms);
+    s.set(3);
+    commit(s);
+    CHECK(x.get() == 1);
+
+    fake_clock::advance(1ms);
+    s.set(4);
+    commit(s);
+    CHECK(x.get() == 4);
+}
+
+TEST_CASE("sample, driven by a periodic reader")
+{
+    auto s    = state<int>{0};
+    auto tick = state<int>{0};
+    auto x    = with(s, tick)
+                 .xform(sample<fake_clock>(10ms) |
+                        zug::map([](int v, int) { return v; }))
+                 .make();
+
+    fake_clock::advance(10ms);
+    s.set(1);
+    commit(s);
+    CHECK(x.get() == 1);
+
+    fake_clock::advance(1ms);
+    s.set(2);
+    commit(s);
+    CHECK(x.get() == 1);
+
+    fake_clock::advance(9ms);
+    tick.set(1);
+    commit(tick);
+    CHECK(x.get() == 2);
+}
+
+TEST_CASE("sample, measures time once per change when written through")
+{
+    auto identity =
+        lenses::getset([](auto&& v) { return LAGER_FWD(v); },
+                       [](auto&&, auto&& x) { return LAGER_FWD(x); });
+    auto s = state<int>{0};
+    auto x = s.xform(sample<fake_clock>(10ms), zug::identity).make();
+    auto c = x[identity].make();
+
+    fake_clock::advance(10ms);
+    c.set(1);
+    commit(s);
+    CHECK(x.get() == 1);
+}
@@ -0,0 +1,88 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/cursor.hpp>
+#include <lager/lenses.hpp>
+#include <lager/state.hpp>
+#include <lager/transducer/window.hpp>
+#include <lager/with.hpp>
+
+#include <zug/transducer/map.hpp>
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+using namespace lager;
+
+TEST_CASE("window_mean, averages the last values")
+{
+    auto s = state<int>{2};
+    auto x = s.xform(window_mean(3)).make();
+    CHECK(x.get() == 2.0);
+
+    auto results = std::vector<double>{};
+    for (auto v : {4, 6, 8, 10}) {
+        s.set(v);
+        commit(s);
+        results.push_back(x.get());
+    }
+    CHECK(results == (std::vector<double>{3.0, 4.0, 6.0, 8.0}));
+}
+
+TEST_CASE("window_max, keeps the maximum of the last values")
+{
+    auto s = state<int>{5};
+    auto x = s.xform(window_max<int>(3)).make();
+    CHECK(x.get() == 5);
+
+    auto results = std::vector<int>{};
+    for (auto v : {1, 2, 3, 7, 1, 2, 1}) {
+        s.set(v);
+        commit(s);
+        results.push_back(x.get());
+    }
+    CHECK(results == (std::vector<int>{5, 5, 3, 7, 7, 7, 2}));
+}
+
+TEST_CASE("window_mean, counts each change once in diamonds")
+{
+    auto s = state<std::pair<int, int>>{std::pair<int, int>{1, 1}};
+    auto a = s[&std::pair<int, int>::first].make();
+    auto b = s[&std::pair<int, int>::second].make();
+    auto x = with(a, b)
+                 .xform(zug::map(std::plus<>{}) | window_mean(3))
+                 .make();
+    CHECK(x.get() == 2.0);
+
+    s.set(std::pair<int, int>{2, 2});
+    commit(s);
+    CHECK(x.get() == 3.0);
+}
+
+TEST_CASE("window_mean, counts each change once when written through")
+{
+    auto identity =
+        lenses::getset([](auto&& v) { return LAGER_FWD(v); },
+                       [](auto&&, auto&& x) { return LAGER_FWD(x); });
+    auto s = state<int>{2};
+    auto x = s.xform(window_mean(3),
+                     zug::map([](double v) { return static_cast<int>(v); }))
+                 .make();
+    auto c = x[identity].make();
+
+    c.set(4.0);
+    commit(s);
+    CHECK(x.get() == 3.0);
+}
@@ -0,0 +1,189 @@
+//
+// lager - library for functional interactive c++ programs
+// Copyright (C) 2017 Juan Pedro Bolivar Puente
+//
+// This file is part of lager.
+//
+// lager is free software: you can redistribute it and/or modify
+// it under the terms of the MIT License, as detailed in the LICENSE
+// file located at the root of this source code distribution,
+// or here: <https://github.com/arximboldi/lager/blob/master/LICENSE>
+//
+
+#include <catch.hpp>
+
+#include <lager/event_loop/manual.hpp>
+#include <lager/fork_join.hpp>
+#include <lager/lenses/attr.hpp>
+#include <lager/store.hpp>
+#include <lager/update_at.hpp>
+
+#include <immer/vector.hpp>
+
+#include <future>
+#include <memory>
+#include <vector>
+
+namespace {
+
+struct probe
+{
+    int value                     = 0;
+    std::shared_ptr<int> compares = std::make_shared<int>(0);
+
+    bool operator==(const probe& x) const
+    {
+        ++*compares;
+        return value == x.value;
+    }
+    bool operator!=(const probe& x) const { return !(*this == x); }
+};
+
+struct model
+{
+    probe a;
+    probe b;
+    std::vector<probe> items;
+
+    // does not compare the probes, so only the cursors count
+    bool operator==(const model& x) const
+    {
+        auto same = [](auto& p, auto& q) { return p.value == q.value; };
+        return same(a, x.a) && same(b, x.b) &&
+               std::equal(items.begin(),
+                          items.end(),
+                          x.items.begin(),
+                          x.items.end(),
+                          same);
+    }
+    bool operator!=(const model& x) const { return !(*this == x); }
+};
+
+struct node
+{
+    int value = 0;
+    immer::vector<int> children;
+};
+
+auto increment = [](auto p) {
+    ++p.value;
+    return p;
+};
+
+model make_model() { return model{{}, {}, {probe{}, probe{}}}; }
+
+} // namespace
+
+TEST_CASE("update_at, members and indices")
+{
+    auto times10 = [](int x) { return x * 10; };
+    auto m = update_at(make_model(), lager::path(&model::a), increment);
+    m      = update_at(m, lager::path(&model::items, 1), increment);
+    m = update_at(m, lager::path(&model::items, 1, &probe::value), times10);
+    CHECK(m.a.value == 1);
+    CHECK(m.b.value == 0);
+    CHECK(m.items[0].value == 0);
+    CHECK(m.items[1].value == 10);
+}
+
+TEST_CASE("update_at, immutable containers")
+{
+    auto n = node{0, {1, 2, 3}};
+    auto r = update_at(n, lager::path(&node::children, 1), [](int x) {
+        return x + 40;
+    });
+    CHECK(n.children[1] == 2);
+    CHECK(r.children[1] == 42);
+}
+
+TEST_CASE("update_at, out of range")
+{
+    auto m = update_at(make_model(), lager::path(&model::items, 5), increment);
+    CHECK(m.items.size() == 2);
+}
+
+TEST_CASE("update_at, store skips cursors out of the updated path")
+{
+    auto store = lager::make_store<int>(
+        make_model(),
+        lager::tracked_reducer([](model m, int) {
+            return update_at(std::move(m), lager::path(&model::a), increment);
+        }),
+        lager::with_manual_event_loop{});
+    auto a     = store[&model::a].make();
+    auto b     = store[&model::b].make();
+    auto item  = store[&model::items][1].make();
+    auto b_cmp = b.get().compares;
+    auto i_cmp = item.get()->compares;
+
+    store.dispatch(0);
+    CHECK(a.get().value == 1);
+    CHECK(*b_cmp == 0);
+    CHECK(*i_cmp == 0);
+}
+
+TEST_CASE("update_at, store propagates along the updated path")
+{
+    auto store = lager::make_store<int>(
+        make_model(),
+        lager::tracked_reducer([](model m, int i) {
+            auto path = lager::path(&model::items, i);
+            return update_at(std::move(m), path, increment);
+        }),
+        lager::with_manual_event_loop{});
+    auto items = store[&model::items].make();
+    auto item0 = store[&model::items][0].make();
+    auto item1 = store[&model::items][1].make();
+    auto value = store[&model::items][1][&probe::value].make();
+
+    store.dispatch(1);
+    CHECK(items.get()[1].value == 1);
+    CHECK(item0.get()->value == 0);
+    CHECK(item1.get()->value == 1);
+    CHECK(value.get() == 1);
+
+    store.dispatch(0);
+    CHECK(item0.get()->value == 1);
+}
+
+TEST_CASE("update_at, untracked reducers update every cursor")
+{
+    auto store = lager::make_store<int>(
+        make_model(),
+        [](model m, int) {
+            m = update_at(std::move(m), lager::path(&model::a), increment);
+            m.b.value = 42;
+            return m;
+        },
+        lager::with_manual_event_loop{});
+    auto b = store[&model::b].make();
+
+    store.dispatch(0);
+    CHECK(b.get().value == 42);
+}
+
+TEST_CASE("update_at, forked reducers update every cursor")
+{
+    auto executor = [](auto fn) {
+        auto done = std::async(std::launch::async, std::move(fn));
+    };
+    auto store    = lager::make_store<int>(
+        make_model(),
+        lager::tracked_reducer(lager::fork_join(
+            executor,
+            lager::slice(lager::lenses::attr(&model::a),
+                         [](probe p, int) { return increment(p); }),
+            lager::slice(lager::lenses::attr(&model::b), [](probe p, int) {
+                return update_at(p, lager::path(&probe::value), [](int x) {
+                    return x + 1;
+                });
+            }))),
+        lager::with_manual_event_loop{});
+    auto value = [](const probe& p) { return p.value; };
+    auto a     = store[&model::a].map(value).make();
+    auto b     = store[&model::b].map(value).make();
+
+    store.dispatch(0);
+    CHECK(a.get() == 1);
+    CHECK(b.get() == 1);
+}
@@ -12,7 +12,13 @@
 
 #include <catch.hpp>
 
+#include <lager/budget.hpp>
+#include <lager/diff.hpp>
+#include <lager/event_loop/queue.hpp>
 #include <lager/state.hpp>
+#include <lager/store.hpp>
+
+#include <immer/map.hpp>
 
 TEST_CASE("watch before assign")
 {
@@ -66,3 +72,267 @@ TEST_CASE("bind")
     CHECK(called == 1);
     CHECK(value == 42);
 }
+
+TEST_CASE("watch diff")
+{
+    auto s      = lager::make_state(42);
+    auto called = 0;
+    auto old    = -1;
+    auto value  = -1;
+    watch_diff(s, [&](int x, int y) {
+        ++called;
+        old   = x;
+        value = y;
+    });
+
+    s.set(5);
+    lager::commit(s);
+    CHECK(called == 1);
+    CHECK(old == 42);
+    CHECK(value == 5);
+
+    s.set(6);
+    lager::commit(s);
+    CHECK(called == 2);
+    CHECK(old == 5);
+    CHECK(value == 6);
+
+    s.set(6);
+    lager::commit(s);
+    CHECK(called == 2);
+}
+
+TEST_CASE("watch diff, old value is the last notified one")
+{
+    auto s      = lager::make_state(0);
+    auto called = 0;
+    auto old    = -1;
+    auto value  = -1;
+    s.watch_diff([&](int x, int y) {
+        ++called;
+        old   = x;
+        value = y;
+    });
+
+    s.set(1);
+    lager::detail::send_down_root(s);
+    s.set(2);
+    lager::detail::send_down_root(s);
+    lager::detail::notify_root(s);
+    CHECK(called == 1);
+    CHECK(old == 0);
+    CHECK(value == 2);
+}
+
+TEST_CASE("watch diff, before assign")
+{
+    auto c      = lager::reader<int>{};
+    auto called = 0;
+    c.watch_diff([&](int x, int y) {
+        ++called;
+        CHECK(x == 42);
+        CHECK(y == 5);
+    });
+
+    auto s = lager::state<int, lager::automatic_tag>(42);
+    c      = s;
+    s.set(5);
+    CHECK(called == 1);
+}
+
+TEST_CASE("watch diff, zoomed member")
+{
+    using pair_t = std::pair<int, int>;
+    auto s       = lager::make_state(pair_t{1, 2});
+    auto f       = s[&pair_t::first].make();
+    auto called  = 0;
+    f.watch_diff([&](int x, int y) {
+        ++called;
+        CHECK(x == 1);
+        CHECK(y == 3);
+    });
+
+    s.set(pair_t{1, 5});
+    lager::commit(s);
+    CHECK(called == 0);
+
+    s.set(pair_t{3, 5});
+    lager::commit(s);
+    CHECK(called == 1);
+}
+
+TEST_CASE("watch diff, change set shared by watchers")
+{
+    using map_t   = immer::map<int, int>;
+    auto s        = lager::make_state(map_t{}.set(1, 1).set(2, 2));
+    auto called   = 0;
+    auto previous = static_cast<const void*>(nullptr);
+    auto check    = [&](auto&& x, auto&& y, auto&& changes) {
+        ++called;
+        CHECK(x.size() == 2);
+        CHECK(y.size() == 2);
+        CHECK(changes.added.size() == 1);
+        CHECK(changes.added[0]->first == 3);
+        CHECK(changes.removed.size() == 1);
+        CHECK(changes.removed[0]->first == 1);
+        CHECK(changes.changed.size() == 1);
+        CHECK(changes.changed[0].first->second == 2);
+        CHECK(changes.changed[0].second->second == 4);
+        if (previous)
+            CHECK(previous == &changes);
+        previous = &changes;
+    };
+    s.watch_diff(check);
+    s.watch_diff(check);
+
+    s.set(s.get().erase(1).set(2, 4).set(3, 3));
+    lager::commit(s);
+    CHECK(called == 2);
+}
+
+TEST_CASE("watch on executor")
+{
+    auto loop   = lager::queue_event_loop{};
+    auto s      = lager::make_state(0, lager::automatic_tag{});
+    auto values = std::vector<int>{};
+    s.watch_on(lager::with_queue_event_loop{loop},
+               [&](int x) { values.push_back(x); });
+
+    s.set(1);
+    s.set(2);
+    s.set(3);
+    CHECK(values.empty());
+
+    loop.step();
+    CHECK(values == (std::vector<int>{1, 2, 3}));
+}
+
+TEST_CASE("watch on executor, skipping intermediate values")
+{
+    auto loop   = lager::queue_event_loop{};
+    auto s      = lager::make_state(0, lager::automatic_tag{});
+    auto values = std::vector<int>{};
+    watch_on(
+        s,
+        lager::with_queue_event_loop{loop},
+        [&](int x) { values.push_back(x); },
+        lager::latest_value_tag{});
+
+    s.set(1);
+    s.set(2);
+    s.set(3);
+    CHECK(values.empty());
+
+    loop.step();
+    CHECK(values == std::vector<int>{3});
+
+    s.set(4);
+    loop.step();
+    CHECK(values == (std::vector<int>{3, 4}));
+}
+
+TEST_CASE("watch priority")
+{
+    auto s     = lager::make_state(0, lager::automatic_tag{});
+    auto order = std::vector<int>{};
+    s.watch([&](int) { order.push_back(0); });
+    s.watch([&](int) { order.push_back(-1); }, lager::watch_priority::low);
+    s.watch([&](int) { order.push_back(1); }, lager::watch_priority::high);
+    s.watch([&](int) { order.push_back(2); });
+
+    s.set(42);
+    CHECK(order == (std::vector<int>{1, 0, 2, -1}));
+}
+
+TEST_CASE("watch priority, across readers of the same node")
+{
+    auto s     = lager::make_state(0, lager::automatic_tag{});
+    auto a     = lager::reader<int>{s};
+    auto b     = lager::reader<int>{s};
+    auto order = std::vector<int>{};
+    a.watch([&](int) { order.push_back(-1); }, lager::watch_priority::low);
+    a.watch([&](int) { order.push_back(0); });
+    b.watch([&](int) { order.push_back(1); }, lager::watch_priority::high);
+    b.watch([&](int) { order.push_back(2); });
+
+    s.set(42);
+    CHECK(order == (std::vector<int>{1, 0, 2, -1}));
+}
+
+TEST_CASE("watch priority, low priority deferred by budget")
+{
+    using namespace std::chrono_literals;
+    auto loop = lager::queue_event_loop{};
+    auto s    = lager::make_state(0);
+    auto high = std::vector<int>{};
+    auto low  = std::vector<int>{};
+    s.watch([&](int x) { high.push_back(x); });
+    s.watch([&](int x) { low.push_back(x); }, lager::watch_priority::low);
+
+    {
+        auto budget =
+            lager::notify_budget{lager::with_queue_event_loop{loop}, 0s};
+        s.set(1);
+        lager::commit(s);
+        s.set(2);
+        lager::commit(s);
+    }
+    CHECK(high == (std::vector<int>{1, 2}));
+    CHECK(low.empty());
+
+    loop.step();
+    CHECK(low == (std::vector<int>{2}));
+
+    s.set(3);
+    lager::commit(s);
+    CHECK(high == (std::vector<int>{1, 2, 3}));
+    CHECK(low == (std::vector<int>{2, 3}));
+}
+
+TEST_CASE("watch priority, store with budget")
+{
+    using namespace std::chrono_literals;
+    auto loop  = lager::queue_event_loop{};
+    auto store = lager::make_store<int>(
+        0,
+        [](int model, int action) { return model + action; },
+        lager::with_queue_event_loop{loop},
+        lager::with_notify_budget(0s));
+    auto high = std::vector<int>{};
+    auto low  = std::vector<int>{};
+    watch(store, [&](int x) { high.push_back(x); });
+    watch(store, [&](int x) { low.push_back(x); }, lager::watch_priority::low);
+
+    store.dispatch(1);
+    store.dispatch(2);
+    CHECK(high.empty());
+    CHECK(low.empty());
+
+    // the queue event loop runs the deferred watchers in the same step, after
+    // all the previously posted events
+    loop.step();
+    CHECK(high == (std::vector<int>{3}));
+    CHECK(low == (std::vector<int>{3}));
+}
+
+TEST_CASE("watch priority, budget event loop destroyed before running")
+{
+    using namespace std::chrono_literals;
+    using budget_loop_t =
+        lager::with_notify_budget_event_loop<lager::with_queue_event_loop>;
+
+    auto loop = lager::queue_event_loop{};
+    auto s    = lager::make_state(0);
+    auto low  = std::vector<int>{};
+    s.watch([&](int x) { low.push_back(x); }, lager::watch_priority::low);
+    {
+        auto budget_loop =
+            budget_loop_t{lager::with_queue_event_loop{loop}, 0s};
+        budget_loop.post([&] {
+            s.set(1);
+            lager::commit(s);
+        });
+    }
+    loop.step();
+    CHECK(low == (std::vector<int>{1}));
+}
@@ -192,6 +192,24 @@ TEST_CASE(
     CHECK(x.get().v == 44); // new value passes
 }
 
+TEST_CASE("xformed, many filtered readers without value")
+{
+    // filtered readers are cheap to construct even when the filter rejects
+    // the initial value, which used to raise and catch an exception
+    auto s       = make_state(1);
+    auto readers = std::vector<reader<int>>{};
+    readers.reserve(100000);
+    for (auto i = 0; i < 100000; ++i)
+        readers.push_back(s.filter([](int a) { return a % 2 == 0; }));
+    CHECK(readers.front().get() == 0);
+    CHECK(readers.back().get() == 0);
+
+    s.set(42);
+    commit(s);
+    CHECK(readers.front().get() == 42);
+    CHECK(readers.back().get() == 42);
+}
+
 TEST_CASE("xformed, identity setter")
 {
     auto s = state<int>{42};